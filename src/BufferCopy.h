@@ -0,0 +1,20 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+
+/*!
+Copies count items, using memcpy only if T is trivially copyable.
+*/
+template <typename T>
+inline void copyItems(T* dest, const T* source, size_t count)
+{
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        memcpy(dest, source, count * sizeof(T));
+    } else {
+        std::copy(source, source + count, dest);
+    }
+}
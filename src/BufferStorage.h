@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define LIBRARY_FILTERS_HAS_MEMORY_RESOURCE
+#endif
+
+
+/*!
+Storage for the runtime-sized buffers (RollingBufferDynamic, CircularBufferDynamic, etc).
+
+The storage is either provided by the user as a span, eg a static array, DMA memory, or memory from an arena,
+in which case it is not owned, or is allocated from a polymorphic memory resource, in which case it is owned
+and is returned to the memory resource on destruction.
+*/
+template <typename T>
+class BufferStorage {
+public:
+    explicit BufferStorage(std::span<T> storage) : _data(storage.data()), _size(storage.size()) {}
+#if defined(LIBRARY_FILTERS_HAS_MEMORY_RESOURCE)
+    BufferStorage(size_t size, std::pmr::memory_resource* resource) :
+        _data(static_cast<T*>(resource->allocate(size*sizeof(T), alignof(T)))),
+        _size(size),
+        _resource(resource)
+    {
+        std::uninitialized_value_construct_n(_data, _size);
+    }
+#endif
+    ~BufferStorage() {
+#if defined(LIBRARY_FILTERS_HAS_MEMORY_RESOURCE)
+        if (_resource) {
+            std::destroy_n(_data, _size);
+            _resource->deallocate(_data, _size*sizeof(T), alignof(T));
+        }
+#endif
+    }
+    BufferStorage(const BufferStorage&) = delete;
+    BufferStorage& operator=(const BufferStorage&) = delete;
+    BufferStorage(BufferStorage&&) = delete;
+    BufferStorage& operator=(BufferStorage&&) = delete;
+public:
+    inline T* data() { return _data; }
+    inline const T* data() const { return _data; }
+    inline size_t size() const { return _size; }
+    inline T& operator[](size_t index) { return _data[index]; }
+    inline const T& operator[](size_t index) const { return _data[index]; }
+private:
+    T* _data;
+    size_t _size;
+#if defined(LIBRARY_FILTERS_HAS_MEMORY_RESOURCE)
+    std::pmr::memory_resource* _resource {nullptr}; //!< nullptr if the storage is not owned
+#endif
+};
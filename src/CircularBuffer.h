@@ -1,8 +1,10 @@
 #pragma once
 
+#include "BufferCopy.h"
 #include <array>
+#include <cassert>
 #include <cstddef>
-#include <cstring>
+#include <utility>
 
 
 /*!
@@ -20,7 +22,30 @@ public:
     inline bool isEmpty() const { return _size == 0; }
     inline bool isFull() const { return _size >= capacity(); }
     bool pushBack(const T& value);
+    bool pushBack(T&& value);
+    /*!
+    Constructs a temporary T from args and move-assigns it into the slot at the back of the buffer.
+    If the buffer is full, returns false without constructing the temporary, so args are not consumed,
+    eg a raw pointer argument is not taken ownership of.
+    */
+    template <typename... Args>
+    bool emplaceBack(Args&&... args);
+    //! Moves the item at the front of the buffer into value.
     bool popFront(T& value);
+    /*!
+    In-place write: returns a pointer to the item in the slot at the back of the buffer, or nullptr if the buffer is full.
+    The slot always holds a live T, so the caller assigns the new value to it (not placement new),
+    and adds it to the buffer by calling commitBack().
+    */
+    inline T* reserveBack() { return isFull() ? nullptr : &_buffer[_end]; }
+    void commitBack();
+    /*!
+    In-place read: returns a pointer to the item at the front of the buffer, or nullptr if the buffer is empty.
+    The item remains in the buffer until releaseFront() is called.
+    */
+    inline T* peekFront() { return isEmpty() ? nullptr : &_buffer[_begin]; }
+    inline const T* peekFront() const { return isEmpty() ? nullptr : &_buffer[_begin]; }
+    void releaseFront();
     inline const T& operator[](size_t index) const {
         size_t pos = _begin + index;
         if (pos > capacity()) {
@@ -32,10 +57,10 @@ public:
     inline const T& back() const { return _end > 0 ? _buffer[_end - 1] : _buffer[CAPACITY]; }
     inline void copy(std::array<T, C>& dest) const {
         if (_end >= _begin) {
-            memcpy(&dest[0], &_buffer[_begin], (_end - _begin) * sizeof(T));
+            copyItems(&dest[0], &_buffer[_begin], _end - _begin);
         } else {
-            memcpy(&dest[0], &_buffer[_begin], (CAPACITY + 1 - _begin) * sizeof(T));
-            memcpy(&dest[CAPACITY + 1 - _begin], &_buffer[0], _end * sizeof(T));
+            copyItems(&dest[0], &_buffer[_begin], CAPACITY + 1 - _begin);
+            copyItems(&dest[CAPACITY + 1 - _begin], &_buffer[0], _end);
         }
     }
     inline size_t getBegin() { return _begin; }
@@ -57,6 +82,7 @@ public:
     };
     const Iterator begin() const { return Iterator(*this, _begin); }
     const Iterator end() const { return Iterator(*this, _end); }
+    friend class SnapshotAccess; // for saveSnapshot() and loadSnapshot(), see Snapshot.h
 private:
     size_t _begin; //!< The virtual beginning of the circular buffer.
     size_t _end;   //!< The virtual end of the circular buffer (one behind the last element).
@@ -65,33 +91,74 @@ private:
 };
 
 template <typename T, size_t C>
-bool CircularBuffer<T, C>::pushBack(const T& value)
+void CircularBuffer<T, C>::commitBack()
 {
-    if (isFull()) {
-        return false;
-    }
+    assert(!isFull() && "commitBack called on full buffer");
     ++_size;
-    _buffer[_end] = value; // sizeof(_buffer) = CAPACITY + 1, so always OK to store value at _end
-    ++_end;
+    ++_end; // sizeof(_buffer) = CAPACITY + 1, so the reserved slot at _end is always valid
     // wrap _end if required
     if (_end > capacity()) {
         _end = 0;
     }
-    return true;
 }
 
 template <typename T, size_t C>
-bool CircularBuffer<T, C>::popFront(T& value)
+void CircularBuffer<T, C>::releaseFront()
 {
-    if (isEmpty()) {
-        return false;
-    }
+    assert(!isEmpty() && "releaseFront called on empty buffer");
     --_size;
-    value = _buffer[_begin];
     ++_begin;
     // wrap _begin if required
     if (_begin > capacity()) {
         _begin = 0;
     }
+}
+
+template <typename T, size_t C>
+bool CircularBuffer<T, C>::pushBack(const T& value)
+{
+    T* slot = reserveBack();
+    if (slot == nullptr) {
+        return false;
+    }
+    *slot = value;
+    commitBack();
+    return true;
+}
+
+template <typename T, size_t C>
+bool CircularBuffer<T, C>::pushBack(T&& value)
+{
+    T* slot = reserveBack();
+    if (slot == nullptr) {
+        return false;
+    }
+    *slot = std::move(value);
+    commitBack();
+    return true;
+}
+
+template <typename T, size_t C>
+template <typename... Args>
+bool CircularBuffer<T, C>::emplaceBack(Args&&... args)
+{
+    T* slot = reserveBack();
+    if (slot == nullptr) {
+        return false;
+    }
+    *slot = T(std::forward<Args>(args)...);
+    commitBack();
+    return true;
+}
+
+template <typename T, size_t C>
+bool CircularBuffer<T, C>::popFront(T& value)
+{
+    T* item = peekFront();
+    if (item == nullptr) {
+        return false;
+    }
+    value = std::move(*item);
+    releaseFront();
     return true;
 }
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "BufferCopy.h"
+#include "BufferStorage.h"
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+
+/*!
+Circular buffer of type T with capacity set at runtime.
+Storage is provided externally, either as a span or from a polymorphic memory resource, see BufferStorage.
+The storage must have capacity + 1 items, use `storageSize()` to calculate this.
+Apart from the capacity, behaves like CircularBuffer.
+*/
+template <typename T>
+class CircularBufferDynamic {
+public:
+    explicit CircularBufferDynamic(std::span<T> storage) : _buffer(storage) { assert(storage.size() >= 2 && "storage must have capacity + 1 items"); }
+#if defined(LIBRARY_FILTERS_HAS_MEMORY_RESOURCE)
+    CircularBufferDynamic(size_t capacity, std::pmr::memory_resource* resource) : _buffer(storageSize(capacity), resource) {}
+#endif
+    static constexpr size_t storageSize(size_t capacity) { return capacity + 1; }
+public:
+    inline size_t size() const { return _size; }
+    inline bool isEmpty() const { return _size == 0; }
+    inline bool isFull() const { return _size >= capacity(); }
+    bool pushBack(const T& value);
+    bool pushBack(T&& value);
+    /*!
+    Constructs a temporary T from args and move-assigns it into the slot at the back of the buffer.
+    If the buffer is full, returns false without constructing the temporary, so args are not consumed,
+    eg a raw pointer argument is not taken ownership of.
+    */
+    template <typename... Args>
+    bool emplaceBack(Args&&... args);
+    //! Moves the item at the front of the buffer into value.
+    bool popFront(T& value);
+    /*!
+    In-place write: returns a pointer to the item in the slot at the back of the buffer, or nullptr if the buffer is full.
+    The slot always holds a live T, so the caller assigns the new value to it (not placement new),
+    and adds it to the buffer by calling commitBack().
+    */
+    inline T* reserveBack() { return isFull() ? nullptr : &_buffer[_end]; }
+    void commitBack();
+    /*!
+    In-place read: returns a pointer to the item at the front of the buffer, or nullptr if the buffer is empty.
+    The item remains in the buffer until releaseFront() is called.
+    */
+    inline T* peekFront() { return isEmpty() ? nullptr : &_buffer[_begin]; }
+    inline const T* peekFront() const { return isEmpty() ? nullptr : &_buffer[_begin]; }
+    void releaseFront();
+    inline const T& operator[](size_t index) const {
+        size_t pos = _begin + index;
+        if (pos > capacity()) {
+            pos -= capacity() + 1;
+        }
+        return _buffer[pos];
+    }
+    inline const T& front() const { return _buffer[_begin]; }
+    inline const T& back() const { return _end > 0 ? _buffer[_end - 1] : _buffer[capacity()]; }
+    inline void copy(std::span<T> dest) const {
+        assert(dest.size() >= _size);
+        if (_end >= _begin) {
+            copyItems(&dest[0], &_buffer[_begin], _end - _begin);
+        } else {
+            copyItems(&dest[0], &_buffer[_begin], (capacity() + 1 - _begin));
+            copyItems(&dest[capacity() + 1 - _begin], &_buffer[0], _end);
+        }
+    }
+    inline size_t getBegin() { return _begin; }
+    inline size_t getEnd() { return _end; }
+
+    inline size_t capacity() const { return _buffer.size() - 1; }
+
+    class Iterator {
+    public:
+        Iterator(const CircularBufferDynamic& rb, size_t pos) : _cb(rb), _pos(pos) {}
+        inline const T& operator*() const { return _cb._buffer[_pos]; }
+        inline const T* operator->() const { return &_cb._buffer[_pos]; }
+        inline Iterator& operator++() { ++_pos; if (_pos > _cb._size) _pos = 0; return *this; }
+        inline bool operator!=(const Iterator& other) const { return _pos != other._pos || &_cb != &other._cb; }
+        size_t pos() const { return _pos; }
+    private:
+        const CircularBufferDynamic& _cb;
+        size_t _pos;
+    };
+    const Iterator begin() const { return Iterator(*this, _begin); }
+    const Iterator end() const { return Iterator(*this, _end); }
+    friend class SnapshotAccess; // for saveSnapshot() and loadSnapshot(), see Snapshot.h
+private:
+    size_t _begin {0}; //!< The virtual beginning of the circular buffer.
+    size_t _end {0};   //!< The virtual end of the circular buffer (one behind the last element).
+    size_t _size {0};  //!< The number of items in the circular buffer.
+    BufferStorage<T> _buffer; // has one spare empty cell so we can avoid _end == _begin when full
+};
+
+template <typename T>
+void CircularBufferDynamic<T>::commitBack()
+{
+    assert(!isFull() && "commitBack called on full buffer");
+    ++_size;
+    ++_end; // _buffer.size() = capacity + 1, so the reserved slot at _end is always valid
+    // wrap _end if required
+    if (_end > capacity()) {
+        _end = 0;
+    }
+}
+
+template <typename T>
+void CircularBufferDynamic<T>::releaseFront()
+{
+    assert(!isEmpty() && "releaseFront called on empty buffer");
+    --_size;
+    ++_begin;
+    // wrap _begin if required
+    if (_begin > capacity()) {
+        _begin = 0;
+    }
+}
+
+template <typename T>
+bool CircularBufferDynamic<T>::pushBack(const T& value)
+{
+    T* slot = reserveBack();
+    if (slot == nullptr) {
+        return false;
+    }
+    *slot = value;
+    commitBack();
+    return true;
+}
+
+template <typename T>
+bool CircularBufferDynamic<T>::pushBack(T&& value)
+{
+    T* slot = reserveBack();
+    if (slot == nullptr) {
+        return false;
+    }
+    *slot = std::move(value);
+    commitBack();
+    return true;
+}
+
+template <typename T>
+template <typename... Args>
+bool CircularBufferDynamic<T>::emplaceBack(Args&&... args)
+{
+    T* slot = reserveBack();
+    if (slot == nullptr) {
+        return false;
+    }
+    *slot = T(std::forward<Args>(args)...);
+    commitBack();
+    return true;
+}
+
+template <typename T>
+bool CircularBufferDynamic<T>::popFront(T& value)
+{
+    T* item = peekFront();
+    if (item == nullptr) {
+        return false;
+    }
+    value = std::move(*item);
+    releaseFront();
+    return true;
+}
@@ -0,0 +1,322 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+/*!
+Polyphase FIR decimator: low-pass filters its input and reduces the sample rate by FACTOR, eg from 8kHz to 1kHz.
+
+The FIR has FACTOR*TAPS_PER_PHASE taps, split into FACTOR phases of TAPS_PER_PHASE taps.
+Only the outputs that are kept are calculated, so each input sample costs TAPS_PER_PHASE multiply-adds,
+rather than the FACTOR*TAPS_PER_PHASE of running the FIR at the full rate and discarding samples.
+(An IIR filter, such as BiquadFilter, cannot be decimated in this way, since each output depends on the previous outputs.)
+
+The coefficients are a Blackman-windowed sinc, set by `initLowPass()` in the same way as the other low-pass filters,
+from the cutoff frequency and the loop time (ie the input sample period).
+The passband edge is typically set a little below the output Nyquist frequency, 0.5/(FACTOR*loopTimeSeconds).
+*/
+template <size_t FACTOR, size_t TAPS_PER_PHASE = 8>
+class PolyphaseDecimator {
+public:
+    static_assert(FACTOR >= 1, "PolyphaseDecimator FACTOR must be at least 1");
+    static_assert(TAPS_PER_PHASE >= 1, "PolyphaseDecimator must have at least one tap per phase");
+    static constexpr size_t TAP_COUNT = FACTOR*TAPS_PER_PHASE;
+public:
+    PolyphaseDecimator() { setToPassthrough(); }
+    PolyphaseDecimator(float cutoffFrequencyHz, float loopTimeSeconds) { initLowPass(cutoffFrequencyHz, loopTimeSeconds); }
+public:
+    inline size_t factor() const { return FACTOR; }
+    inline void reset() { _delay = {}; _phase = 0; _head = 0; }
+    //! Resets to the DC steady state for value, the coefficients have unity DC gain, so the output is value.
+    inline void reset(float value) { for (auto& line : _delay) { line.fill(value); } _phase = 0; _head = 0; }
+    //! Sets the coefficients so that the decimator just keeps every FACTORth sample.
+    inline void setToPassthrough() { _coefficients = {}; _coefficients[FACTOR - 1][0] = 1.0F; reset(); }
+    void initLowPass(float cutoffFrequencyHz, float loopTimeSeconds);
+    //! Returns the tap-th coefficient of the FIR, before it is split into phases.
+    inline float getCoefficient(size_t tap) const { return _coefficients[FACTOR - 1 - tap % FACTOR][tap / FACTOR]; }
+
+    /*!
+    Adds input to the filter. Every FACTOR inputs returns true and sets output to the next output sample,
+    otherwise returns false and leaves output unchanged.
+    */
+    inline bool filter(float input, float& output);
+    /*!
+    Filters a block of count inputs, writing an output for every FACTOR inputs. Returns the number of outputs written.
+    Blocks need not be multiples of FACTOR: the phase is carried between calls.
+    */
+    size_t filter(const float* input, float* output, size_t count);
+private:
+    inline float calculateOutput() const;
+private:
+    //! _coefficients[phase][tap], for input phase `phase`, where `tap` is the number of output periods ago.
+    std::array<std::array<float, TAPS_PER_PHASE>, FACTOR> _coefficients {};
+    //! Delay line for each phase, stored twice so the most recent TAPS_PER_PHASE samples are contiguous from _head.
+    std::array<std::array<float, 2*TAPS_PER_PHASE>, FACTOR> _delay {};
+    size_t _phase {0}; //!< Phase of the next input
+    size_t _head {0}; //!< Position of the most recent sample in each delay line
+};
+
+template <size_t FACTOR, size_t TAPS_PER_PHASE>
+void PolyphaseDecimator<FACTOR, TAPS_PER_PHASE>::initLowPass(float cutoffFrequencyHz, float loopTimeSeconds)
+{
+    constexpr float PI_F = 3.14159265358979323846F;
+    const float normalizedCutoff = 2.0F*cutoffFrequencyHz*loopTimeSeconds; // as a fraction of the input Nyquist frequency
+    const float center = static_cast<float>(TAP_COUNT - 1)*0.5F;
+    std::array<float, TAP_COUNT> taps {};
+    float sum = 0.0F;
+    for (size_t ii = 0; ii < TAP_COUNT; ++ii) {
+        const float x = static_cast<float>(ii) - center;
+        const float sinc = (x == 0.0F) ? normalizedCutoff : sinf(PI_F*normalizedCutoff*x)/(PI_F*x);
+        const float phase = TAP_COUNT == 1 ? 0.0F : 2.0F*PI_F*static_cast<float>(ii)/static_cast<float>(TAP_COUNT - 1);
+        const float blackman = 0.42F - 0.5F*cosf(phase) + 0.08F*cosf(2.0F*phase);
+        taps[ii] = sinc*blackman;
+        sum += taps[ii];
+    }
+    // split into phases, normalized to unity DC gain
+    // the output is calculated after the input with phase FACTOR - 1, so tap k applies to the input with phase FACTOR - 1 - k % FACTOR
+    for (size_t ii = 0; ii < TAP_COUNT; ++ii) {
+        _coefficients[FACTOR - 1 - ii % FACTOR][ii / FACTOR] = taps[ii]/sum;
+    }
+    reset();
+}
+
+template <size_t FACTOR, size_t TAPS_PER_PHASE>
+inline float PolyphaseDecimator<FACTOR, TAPS_PER_PHASE>::calculateOutput() const
+{
+    float output = 0.0F;
+    for (size_t phase = 0; phase < FACTOR; ++phase) {
+        const float* delay = &_delay[phase][_head];
+        const float* coefficients = &_coefficients[phase][0];
+        for (size_t ii = 0; ii < TAPS_PER_PHASE; ++ii) {
+            output += coefficients[ii]*delay[ii];
+        }
+    }
+    return output;
+}
+
+template <size_t FACTOR, size_t TAPS_PER_PHASE>
+inline bool PolyphaseDecimator<FACTOR, TAPS_PER_PHASE>::filter(float input, float& output)
+{
+    _delay[_phase][_head] = input;
+    _delay[_phase][_head + TAPS_PER_PHASE] = input;
+    ++_phase;
+    if (_phase < FACTOR) {
+        return false;
+    }
+    output = calculateOutput();
+    _phase = 0;
+    // move the head back, so the next inputs become the most recent, and the oldest are dropped
+    _head = (_head == 0) ? TAPS_PER_PHASE - 1 : _head - 1;
+    return true;
+}
+
+template <size_t FACTOR, size_t TAPS_PER_PHASE>
+size_t PolyphaseDecimator<FACTOR, TAPS_PER_PHASE>::filter(const float* input, float* output, size_t count)
+{
+    size_t outputCount = 0;
+    for (size_t ii = 0; ii < count; ++ii) {
+        if (filter(input[ii], output[outputCount])) {
+            ++outputCount;
+        }
+    }
+    return outputCount;
+}
+
+
+/*!
+Cascaded integrator-comb (CIC) decimator of order ORDER, reducing the sample rate by RATE, with differential delay DELAY.
+
+Uses only integer additions and subtractions. The integrators are allowed to overflow: all arithmetic is done
+modulo 2^bits (in the unsigned type of T), and the combs undo the wraparound, so the output is correct provided
+it fits in T. That is, T must have at least ORDER*log2(RATE*DELAY) more bits than the input.
+
+The DC gain is GAIN = (RATE*DELAY)^ORDER. The frequency response droops across the passband, this can be corrected
+with a CICCompensator running at the output rate, which can then feed FilterMovingAverage or the biquads.
+*/
+template <size_t ORDER, size_t RATE, size_t DELAY = 1, typename T = int32_t>
+class CICDecimator {
+public:
+    static_assert(ORDER >= 1 && RATE >= 1 && DELAY >= 1, "CICDecimator ORDER, RATE, and DELAY must be at least 1");
+    static_assert(std::is_integral_v<T> && std::is_signed_v<T>, "CICDecimator T must be a signed integer type");
+    using unsigned_t = std::make_unsigned_t<T>;
+    static constexpr uint64_t gainPower(size_t order) { return order == 0 ? 1 : RATE*DELAY*gainPower(order - 1); }
+    static constexpr uint64_t GAIN = gainPower(ORDER);
+public:
+    inline void reset() { _integrators = {}; _combs = {}; _phase = 0; _combIndex = 0; }
+    /*!
+    Adds input to the filter. Every RATE inputs returns true and sets output to the next output sample,
+    otherwise returns false and leaves output unchanged.
+    */
+    inline bool filter(T input, T& output);
+    //! Filters a block of count inputs, writing an output for every RATE inputs. Returns the number of outputs written.
+    inline size_t filter(const T* input, T* output, size_t count) {
+        size_t outputCount = 0;
+        for (size_t ii = 0; ii < count; ++ii) {
+            if (filter(input[ii], output[outputCount])) {
+                ++outputCount;
+            }
+        }
+        return outputCount;
+    }
+private:
+    std::array<unsigned_t, ORDER> _integrators {};
+    std::array<std::array<unsigned_t, DELAY>, ORDER> _combs {}; //!< Delay line of each comb
+    size_t _phase {0};
+    size_t _combIndex {0}; //!< Position of the oldest value in the comb delay lines
+};
+
+template <size_t ORDER, size_t RATE, size_t DELAY, typename T>
+inline bool CICDecimator<ORDER, RATE, DELAY, T>::filter(T input, T& output)
+{
+    unsigned_t value = static_cast<unsigned_t>(input);
+    for (unsigned_t& integrator : _integrators) {
+        integrator = static_cast<unsigned_t>(integrator + value);
+        value = integrator;
+    }
+    ++_phase;
+    if (_phase < RATE) {
+        return false;
+    }
+    _phase = 0;
+    for (auto& comb : _combs) {
+        const unsigned_t delayed = comb[_combIndex];
+        comb[_combIndex] = value;
+        value = static_cast<unsigned_t>(value - delayed);
+    }
+    _combIndex = (_combIndex + 1 == DELAY) ? 0 : _combIndex + 1;
+    output = static_cast<T>(value);
+    return true;
+}
+
+
+/*!
+Cascaded integrator-comb (CIC) interpolator of order ORDER, increasing the sample rate by RATE, with differential delay DELAY.
+
+Uses only integer additions and subtractions, modulo 2^bits, see CICDecimator.
+The DC gain is GAIN = (RATE*DELAY)^ORDER/RATE. T must have at least log2(GAIN) more bits than the input.
+*/
+template <size_t ORDER, size_t RATE, size_t DELAY = 1, typename T = int32_t>
+class CICInterpolator {
+public:
+    static_assert(ORDER >= 1 && RATE >= 1 && DELAY >= 1, "CICInterpolator ORDER, RATE, and DELAY must be at least 1");
+    static_assert(std::is_integral_v<T> && std::is_signed_v<T>, "CICInterpolator T must be a signed integer type");
+    using unsigned_t = std::make_unsigned_t<T>;
+    static constexpr uint64_t GAIN = CICDecimator<ORDER, RATE, DELAY, T>::GAIN / RATE;
+public:
+    inline void reset() { _integrators = {}; _combs = {}; _combIndex = 0; }
+    //! Filters one input sample, writing RATE output samples.
+    inline void filter(T input, T* output);
+private:
+    std::array<unsigned_t, ORDER> _integrators {};
+    std::array<std::array<unsigned_t, DELAY>, ORDER> _combs {};
+    size_t _combIndex {0};
+};
+
+template <size_t ORDER, size_t RATE, size_t DELAY, typename T>
+inline void CICInterpolator<ORDER, RATE, DELAY, T>::filter(T input, T* output)
+{
+    unsigned_t value = static_cast<unsigned_t>(input);
+    for (auto& comb : _combs) {
+        const unsigned_t delayed = comb[_combIndex];
+        comb[_combIndex] = value;
+        value = static_cast<unsigned_t>(value - delayed);
+    }
+    _combIndex = (_combIndex + 1 == DELAY) ? 0 : _combIndex + 1;
+    // zero-stuff: the comb output is the integrator input for the first output sample, zero for the rest
+    for (size_t ii = 0; ii < RATE; ++ii) {
+        for (unsigned_t& integrator : _integrators) {
+            integrator = static_cast<unsigned_t>(integrator + value);
+            value = integrator;
+        }
+        output[ii] = static_cast<T>(value);
+        value = 0;
+    }
+}
+
+
+/*!
+FIR filter, running at the low rate, that compensates for the passband droop of a CIC filter.
+
+`init()` designs TAPS symmetrical coefficients whose response is the inverse of the CIC response up to the passband edge,
+falling to zero over a transition band of about 3.3/TAPS above it, by integrating the desired response and applying a Hamming window.
+The coefficients have unity DC gain.
+The input is the CIC output divided by the CIC gain, so that the overall DC gain is one.
+*/
+template <size_t TAPS>
+class CICCompensator {
+public:
+    static_assert(TAPS >= 3, "CICCompensator must have at least 3 taps");
+public:
+    /*!
+    Designs the compensator for a CIC filter of the given order, rate, and differential delay.
+    passband is the passband edge as a fraction of the low (output) sample rate, so must be less than 0.5.
+    */
+    void init(size_t order, size_t rate, size_t delay, float passband);
+    inline void reset() { _delay = {}; _head = 0; }
+    inline void reset(float value) { _delay.fill(value); _head = 0; }
+    inline float getCoefficient(size_t tap) const { return _coefficients[tap]; }
+    //! Returns the magnitude of the CIC response, normalized to unity DC gain, at frequency as a fraction of the low sample rate.
+    static float cicResponse(size_t order, size_t rate, size_t delay, float frequency);
+
+    inline float filter(float input) {
+        _head = (_head == 0) ? TAPS - 1 : _head - 1;
+        _delay[_head] = input;
+        _delay[_head + TAPS] = input;
+        float output = 0.0F;
+        for (size_t ii = 0; ii < TAPS; ++ii) {
+            output += _coefficients[ii]*_delay[_head + ii];
+        }
+        return output;
+    }
+private:
+    std::array<float, TAPS> _coefficients {};
+    std::array<float, 2*TAPS> _delay {}; //!< Stored twice so the most recent TAPS samples are contiguous from _head.
+    size_t _head {0};
+};
+
+template <size_t TAPS>
+float CICCompensator<TAPS>::cicResponse(size_t order, size_t rate, size_t delay, float frequency)
+{
+    constexpr float PI_F = 3.14159265358979323846F;
+    const float x = PI_F*static_cast<float>(delay)*frequency;
+    if (x == 0.0F) {
+        return 1.0F;
+    }
+    const float response = sinf(x)/(static_cast<float>(rate)*sinf(x/static_cast<float>(rate)));
+    return std::pow(std::fabs(response), static_cast<float>(order));
+}
+
+template <size_t TAPS>
+void CICCompensator<TAPS>::init(size_t order, size_t rate, size_t delay, float passband)
+{
+    assert(passband > 0.0F && passband < 0.5F && "passband must be between 0 and 0.5");
+    constexpr float PI_F = 3.14159265358979323846F;
+    constexpr size_t STEPS = 512;
+    const float center = static_cast<float>(TAPS - 1)*0.5F;
+    // place the cutoff half the Hamming transition width above the passband edge, so the passband is flat up to its edge
+    const float cutoff = std::fmin(passband + 1.65F/static_cast<float>(TAPS), 0.5F);
+    const float step = cutoff/static_cast<float>(STEPS);
+    float sum = 0.0F;
+    for (size_t ii = 0; ii < TAPS; ++ii) {
+        const float n = static_cast<float>(ii) - center;
+        // h[n] = 2 * integral from 0 to cutoff of desired(f)*cos(2*pi*f*n), by the midpoint rule
+        float tap = 0.0F;
+        for (size_t jj = 0; jj < STEPS; ++jj) {
+            const float frequency = (static_cast<float>(jj) + 0.5F)*step;
+            tap += cosf(2.0F*PI_F*frequency*n)/cicResponse(order, rate, delay, frequency);
+        }
+        tap *= 2.0F*step;
+        const float hamming = 0.54F - 0.46F*cosf(2.0F*PI_F*static_cast<float>(ii)/static_cast<float>(TAPS - 1));
+        _coefficients[ii] = tap*hamming;
+        sum += _coefficients[ii];
+    }
+    for (float& coefficient : _coefficients) {
+        coefficient /= sum;
+    }
+    reset();
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__SSE__) || defined(__x86_64__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+/*!
+Denormal protection for decaying filter states.
+
+When the input to a recursive filter goes quiet the filter state decays towards zero and eventually becomes subnormal.
+On many processors arithmetic on subnormal floats is very much slower than normal arithmetic, causing latency spikes.
+
+Protection is opt-in and selected at compile time:
+
+1. define `LIBRARY_FILTERS_USE_DENORMAL_SNAP` to snap filter states whose magnitude falls below `DENORMAL_SNAP_THRESHOLD` to zero.
+2. define `LIBRARY_FILTERS_USE_DENORMAL_DC_OFFSET` to add a tiny DC offset to filter inputs, so low-pass states never decay below it.
+
+With neither defined `denormalSnap` and `denormalOffset` return their argument unchanged and so have no cost.
+Alternatively `ScopedFlushDenormals` may be used to set the processor's flush-to-zero mode for the duration of a scope.
+*/
+static constexpr float DENORMAL_SNAP_THRESHOLD = 1.0e-20F;
+static constexpr float DENORMAL_DC_OFFSET = 1.0e-18F;
+
+inline float denormalSnap(float value)
+{
+#if defined(LIBRARY_FILTERS_USE_DENORMAL_SNAP)
+    return (value < DENORMAL_SNAP_THRESHOLD && value > -DENORMAL_SNAP_THRESHOLD) ? 0.0F : value;
+#else
+    return value;
+#endif
+}
+
+inline float denormalOffset(float input)
+{
+#if defined(LIBRARY_FILTERS_USE_DENORMAL_DC_OFFSET)
+    return input + DENORMAL_DC_OFFSET;
+#else
+    return input;
+#endif
+}
+
+//! Non-float types (eg xyz_t) are passed through unchanged.
+template <typename T>
+inline const T& denormalSnap(const T& value) { return value; }
+
+template <typename T>
+inline const T& denormalOffset(const T& input) { return input; }
+
+
+/*!
+Scoped flush-to-zero guard.
+
+Sets the floating point unit to flush subnormal results (and, on x86, subnormal inputs) to zero, restoring the previous mode on destruction.
+Supported on x86 (SSE MXCSR FTZ and DAZ bits), AArch64 (FPCR FZ bit) and 32-bit ARM with an FPU (FPSCR FZ bit).
+On other targets it does nothing.
+Note that the mode is per thread.
+*/
+class ScopedFlushDenormals {
+public:
+    ScopedFlushDenormals() {
+#if defined(__SSE__) || defined(__x86_64__) || defined(_M_X64)
+        _saved = _mm_getcsr();
+        _mm_setcsr(static_cast<unsigned int>(_saved | MXCSR_FTZ | MXCSR_DAZ));
+#elif defined(__aarch64__)
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(_saved));
+        const uint64_t fpcr = _saved | FPCR_FZ;
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+#elif defined(__arm__) && defined(__ARM_FP)
+        _saved = __builtin_arm_get_fpscr();
+        __builtin_arm_set_fpscr(static_cast<unsigned int>(_saved | FPCR_FZ));
+#endif
+    }
+    ~ScopedFlushDenormals() {
+#if defined(__SSE__) || defined(__x86_64__) || defined(_M_X64)
+        _mm_setcsr(static_cast<unsigned int>(_saved));
+#elif defined(__aarch64__)
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(_saved));
+#elif defined(__arm__) && defined(__ARM_FP)
+        __builtin_arm_set_fpscr(static_cast<unsigned int>(_saved));
+#endif
+    }
+    ScopedFlushDenormals(const ScopedFlushDenormals&) = delete;
+    ScopedFlushDenormals& operator=(const ScopedFlushDenormals&) = delete;
+    ScopedFlushDenormals(ScopedFlushDenormals&&) = delete;
+    ScopedFlushDenormals& operator=(ScopedFlushDenormals&&) = delete;
+private:
+    static constexpr uint64_t MXCSR_FTZ = 0x8000; //!< x86 MXCSR flush to zero
+    static constexpr uint64_t MXCSR_DAZ = 0x0040; //!< x86 MXCSR denormals are zero
+    static constexpr uint64_t FPCR_FZ = 1U << 24U; //!< ARM FPCR/FPSCR flush to zero
+    uint64_t _saved {};
+};
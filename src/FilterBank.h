@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+
+/*!
+Bank of CHANNELS independent filters of type FILTER, eg PowerTransferFilter1 or BiquadFilter.
+
+The channels are partitioned into chunks of CHUNK_SIZE filters. Each chunk is aligned to, and padded to a multiple of,
+the cache line size, so threads processing different chunks never write to the same cache line.
+
+The bank does not own any threads. Each worker thread calls `filterChunks()` with a shared chunk counter and claims chunks
+one at a time until none remain, so a thread that finishes early takes over the remaining work.
+This means the bank can be driven by any thread pool, eg FilterBankThreadPool, which also balances the work by stealing chunks,
+or by a single thread using `filter()`.
+
+Blocks of samples are stored channel-major, that is sample `i` of channel `c` is at `input[c*sampleCount + i]`.
+To avoid false sharing on the output, choose CHUNK_SIZE*sampleCount to be a multiple of CACHE_LINE_SIZE/sizeof(float).
+*/
+template <typename FILTER, size_t CHANNELS, size_t CHUNK_SIZE = 64>
+class FilterBank {
+public:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t CHUNK_COUNT = (CHANNELS + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    struct alignas(CACHE_LINE_SIZE) chunk_t {
+        std::array<FILTER, CHUNK_SIZE> filters;
+    };
+    static_assert(CHUNK_SIZE > 0, "FilterBank CHUNK_SIZE must be greater than zero");
+public:
+    inline size_t size() const { return CHANNELS; }
+    inline size_t chunkCount() const { return CHUNK_COUNT; }
+    inline FILTER& operator[](size_t channel) { return _chunks[channel / CHUNK_SIZE].filters[channel % CHUNK_SIZE]; }
+    inline const FILTER& operator[](size_t channel) const { return _chunks[channel / CHUNK_SIZE].filters[channel % CHUNK_SIZE]; }
+
+    inline void reset() { for (chunk_t& chunk : _chunks) { for (FILTER& filter : chunk.filters) { filter.reset(); } } }
+
+    //! Filter a block of sampleCount samples on each channel of the chunk.
+    void filterChunk(size_t chunkIndex, const float* input, float* output, size_t sampleCount);
+    //! Filter a block of sampleCount samples on every channel, on the calling thread.
+    inline void filter(const float* input, float* output, size_t sampleCount) {
+        for (size_t ii = 0; ii < CHUNK_COUNT; ++ii) {
+            filterChunk(ii, input, output, sampleCount);
+        }
+    }
+    //! Filter one sample on every channel.
+    inline void filter(const float* input, float* output) { filter(input, output, 1); }
+    /*!
+    Worker function: claims chunks from nextChunk and filters them until all chunks have been claimed.
+    nextChunk must be set to zero before the workers start.
+    */
+    inline void filterChunks(std::atomic<size_t>& nextChunk, const float* input, float* output, size_t sampleCount) {
+        for (size_t ii = nextChunk.fetch_add(1, std::memory_order_relaxed); ii < CHUNK_COUNT; ii = nextChunk.fetch_add(1, std::memory_order_relaxed)) {
+            filterChunk(ii, input, output, sampleCount);
+        }
+    }
+private:
+    std::array<chunk_t, CHUNK_COUNT> _chunks {};
+};
+
+template <typename FILTER, size_t CHANNELS, size_t CHUNK_SIZE>
+void FilterBank<FILTER, CHANNELS, CHUNK_SIZE>::filterChunk(size_t chunkIndex, const float* input, float* output, size_t sampleCount)
+{
+    const size_t channelBegin = chunkIndex*CHUNK_SIZE;
+    const size_t channelCount = (CHANNELS - channelBegin < CHUNK_SIZE) ? CHANNELS - channelBegin : CHUNK_SIZE;
+    chunk_t& chunk = _chunks[chunkIndex];
+    for (size_t ii = 0; ii < channelCount; ++ii) {
+        // filter a local copy, so the compiler keeps the state in registers, rather than storing it after every sample in case output aliases it
+        FILTER filter = chunk.filters[ii];
+        const float* in = input + (channelBegin + ii)*sampleCount;
+        float* out = output + (channelBegin + ii)*sampleCount;
+        for (size_t jj = 0; jj < sampleCount; ++jj) {
+            out[jj] = filter.filter(in[jj]);
+        }
+        chunk.filters[ii] = filter;
+    }
+}
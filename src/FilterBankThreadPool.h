@@ -0,0 +1,204 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/*!
+Work-stealing thread pool for FilterBank.
+
+The pool has threadCount threads: the thread calling `filter()` and threadCount - 1 worker threads, which are started
+by the constructor and wait between blocks, so no threads are created per block.
+
+For each block the bank's chunks are split into threadCount contiguous ranges, one per thread.
+Each thread takes chunks from the front of its own range. A thread whose range is empty steals the back half of
+the range of another thread, and continues with that, so the work stays balanced when some threads run slower,
+eg because they are preempted, without the threads contending on a single shared counter.
+
+Each range is a single atomic word, in its own cache line, so threads do not falsely share ranges either.
+
+Requires std::thread, so it is in its own header, and FilterBank.h can still be used where threads are not available.
+*/
+class FilterBankThreadPool {
+public:
+    explicit FilterBankThreadPool(size_t threadCount);
+    ~FilterBankThreadPool();
+    FilterBankThreadPool(const FilterBankThreadPool&) = delete;
+    FilterBankThreadPool& operator=(const FilterBankThreadPool&) = delete;
+    FilterBankThreadPool(FilterBankThreadPool&&) = delete;
+    FilterBankThreadPool& operator=(FilterBankThreadPool&&) = delete;
+public:
+    inline size_t threadCount() const { return _ranges.size(); }
+    //! Filter a block of sampleCount samples on every channel of bank, using all the threads of the pool. Returns when the block is complete.
+    template <typename BANK>
+    void filter(BANK& bank, const float* input, float* output, size_t sampleCount);
+    //! Calls job(context, chunkIndex) once for every chunkIndex less than chunkCount, using all the threads of the pool.
+    void run(size_t chunkCount, void (*job)(void* context, size_t chunkIndex), void* context);
+private:
+    //! A range of chunks [begin, end), packed into one word so it can be updated atomically.
+    struct alignas(64) range_t {
+        std::atomic<uint64_t> value {0};
+    };
+    static inline uint64_t pack(uint64_t begin, uint64_t end) { return (begin << 32U) | end; }
+    static inline uint32_t rangeBegin(uint64_t range) { return static_cast<uint32_t>(range >> 32U); }
+    static inline uint32_t rangeEnd(uint64_t range) { return static_cast<uint32_t>(range); }
+    bool claimChunk(size_t threadIndex, size_t& chunkIndex);
+    bool stealChunks(size_t threadIndex);
+    void work(size_t threadIndex);
+    void workerLoop(size_t threadIndex);
+private:
+    std::vector<range_t> _ranges; //!< The range of chunks of each thread, thread 0 is the thread calling run().
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _startCondition;
+    std::condition_variable _doneCondition;
+    uint64_t _generation {0}; //!< Incremented for each block, guarded by _mutex.
+    size_t _busyWorkers {0}; //!< Number of worker threads still working on the current block, guarded by _mutex.
+    bool _stop {false};
+    void (*_job)(void* context, size_t chunkIndex) {nullptr};
+    void* _context {nullptr};
+};
+
+inline FilterBankThreadPool::FilterBankThreadPool(size_t threadCount) :
+    _ranges(threadCount == 0 ? 1 : threadCount)
+{
+    _workers.reserve(_ranges.size() - 1);
+    for (size_t ii = 1; ii < _ranges.size(); ++ii) {
+        _workers.emplace_back(&FilterBankThreadPool::workerLoop, this, ii);
+    }
+}
+
+inline FilterBankThreadPool::~FilterBankThreadPool()
+{
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _startCondition.notify_all();
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+template <typename BANK>
+void FilterBankThreadPool::filter(BANK& bank, const float* input, float* output, size_t sampleCount)
+{
+    struct context_t {
+        BANK& bank;
+        const float* input;
+        float* output;
+        size_t sampleCount;
+    };
+    context_t context { bank, input, output, sampleCount };
+    run(bank.chunkCount(), [](void* contextPtr, size_t chunkIndex) {
+        context_t& c = *static_cast<context_t*>(contextPtr);
+        c.bank.filterChunk(chunkIndex, c.input, c.output, c.sampleCount);
+    }, &context);
+}
+
+inline void FilterBankThreadPool::run(size_t chunkCount, void (*job)(void* context, size_t chunkIndex), void* context)
+{
+    // split the chunks into contiguous ranges, one per thread
+    const size_t count = _ranges.size();
+    for (size_t ii = 0; ii < count; ++ii) {
+        _ranges[ii].value.store(pack(chunkCount*ii/count, chunkCount*(ii + 1)/count), std::memory_order_relaxed);
+    }
+    if (_workers.empty()) {
+        _job = job;
+        _context = context;
+        work(0);
+        return;
+    }
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        _job = job;
+        _context = context;
+        _busyWorkers = _workers.size();
+        ++_generation;
+    }
+    _startCondition.notify_all();
+    work(0);
+    std::unique_lock<std::mutex> lock(_mutex);
+    _doneCondition.wait(lock, [this]() { return _busyWorkers == 0; });
+}
+
+inline void FilterBankThreadPool::workerLoop(size_t threadIndex)
+{
+    uint64_t generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _startCondition.wait(lock, [this, generation]() { return _stop || _generation != generation; });
+            if (_stop) {
+                return;
+            }
+            generation = _generation;
+        }
+        work(threadIndex);
+        bool done = false;
+        {
+            const std::lock_guard<std::mutex> lock(_mutex);
+            --_busyWorkers;
+            done = (_busyWorkers == 0);
+        }
+        if (done) {
+            _doneCondition.notify_one();
+        }
+    }
+}
+
+inline void FilterBankThreadPool::work(size_t threadIndex)
+{
+    size_t chunkIndex = 0;
+    do {
+        while (claimChunk(threadIndex, chunkIndex)) {
+            _job(_context, chunkIndex);
+        }
+    } while (stealChunks(threadIndex));
+}
+
+/*!
+Takes the chunk at the front of the thread's own range.
+*/
+inline bool FilterBankThreadPool::claimChunk(size_t threadIndex, size_t& chunkIndex)
+{
+    std::atomic<uint64_t>& value = _ranges[threadIndex].value;
+    uint64_t range = value.load(std::memory_order_acquire);
+    while (rangeBegin(range) < rangeEnd(range)) {
+        if (value.compare_exchange_weak(range, pack(rangeBegin(range) + 1U, rangeEnd(range)), std::memory_order_acq_rel, std::memory_order_acquire)) {
+            chunkIndex = rangeBegin(range);
+            return true;
+        }
+    }
+    return false;
+}
+
+/*!
+Steals the back half of the range of the first other thread with chunks remaining, and makes it the thread's own range.
+Returns false if no thread has chunks remaining.
+The thread's own range is empty, so no other thread can change it, and it can be stored rather than exchanged.
+A range, once its first chunk is claimed, is never set again during the block, so the exchanges do not suffer from the ABA problem.
+*/
+inline bool FilterBankThreadPool::stealChunks(size_t threadIndex)
+{
+    const size_t count = _ranges.size();
+    for (size_t ii = 1; ii < count; ++ii) {
+        std::atomic<uint64_t>& victim = _ranges[(threadIndex + ii) % count].value;
+        uint64_t range = victim.load(std::memory_order_acquire);
+        while (rangeBegin(range) < rangeEnd(range)) {
+            const uint32_t begin = rangeBegin(range);
+            const uint32_t end = rangeEnd(range);
+            const uint32_t split = end - (end - begin + 1U)/2U;
+            if (victim.compare_exchange_weak(range, pack(begin, split), std::memory_order_acq_rel, std::memory_order_acquire)) {
+                _ranges[threadIndex].value.store(pack(split, end), std::memory_order_release);
+                return true;
+            }
+        }
+    }
+    return false;
+}
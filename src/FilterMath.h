@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+
+/*!
+Cutoff correction for a power transfer filter of order n, 1/sqrt(2^(1/n) - 1), calculated at compile time.
+
+2^(1/n) - 1 is calculated as expm1(ln(2)/n) by its Taylor series, rather than by subtracting 1 from 2^(1/n),
+so it keeps its precision for large n, where 2^(1/n) is close to 1.
+Both the series and the square root are iterated until they stop changing, so the result is accurate for any n.
+*/
+constexpr double powerTransferCutoffCorrection(size_t n)
+{
+    constexpr double LN2 = 0.693147180559945309417;
+    const double y = LN2 / static_cast<double>(n);
+    // expm1(y) = y + y^2/2! + y^3/3! + ..., all terms positive since y > 0
+    double rootOf2Minus1 = 0.0;
+    double term = y;
+    for (size_t k = 2; rootOf2Minus1 + term != rootOf2Minus1; ++k) {
+        rootOf2Minus1 += term;
+        term *= y / static_cast<double>(k);
+    }
+    // Newton's method for the square root, starting above the root, so the iterates decrease until they converge
+    double x = rootOf2Minus1 > 1.0 ? rootOf2Minus1 : 1.0;
+    for (;;) {
+        const double next = 0.5*(x + rootOf2Minus1/x);
+        if (next >= x) {
+            break;
+        }
+        x = next;
+    }
+    return 1.0/x;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "BufferStorage.h"
+#include "Filters.h"
+#include <cassert>
+#include <cstddef>
+#include <span>
+
+
+/*!
+Simple moving average filter with window length set at runtime.
+Storage for the N samples of the window is provided externally, either as a span or from a polymorphic memory resource, see BufferStorage.
+Apart from the window length, behaves like FilterMovingAverage.
+*/
+class FilterMovingAverageDynamic : public FilterBase {
+public:
+    explicit FilterMovingAverageDynamic(std::span<float> storage) : _samples(storage) { assert(!storage.empty() && "storage cannot be empty"); }
+#if defined(LIBRARY_FILTERS_HAS_MEMORY_RESOURCE)
+    FilterMovingAverageDynamic(size_t N, std::pmr::memory_resource* resource) : _samples(N, resource) {}
+#endif
+public:
+    inline void reset() { _sum = 0.0F; _count = 0; _index = 0;}
+    inline void reset(float value) { for (size_t ii = 0; ii < _samples.size(); ++ii) { _samples[ii] = value; } _sum = value*static_cast<float>(_samples.size()); _count = _samples.size(); _index = 0; }
+
+    inline float filter(float input);
+    inline float filter(float input, float dT) { (void)dT; return filter(input); }
+    LIBRARY_FILTERS_VIRTUAL float filterVirtual(float input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
+
+    inline size_t windowSize() const { return _samples.size(); }
+
+    friend class SnapshotAccess; // for saveSnapshot() and loadSnapshot(), see Snapshot.h
+protected:
+    size_t _count {0};
+    size_t _index {0};
+    float _sum {0};
+    BufferStorage<float> _samples;
+};
+
+inline float FilterMovingAverageDynamic::filter(float input)
+{
+    const size_t N = _samples.size();
+    _sum += input;
+    if (_count < N) {
+        _samples[_index++] = input;
+        ++_count;
+        return _sum/static_cast<float>(_count);
+    } else {
+        if (_index == N) {
+            _index = 0;
+        }
+        _sum -= _samples[_index];
+        _samples[_index++] = input;
+    }
+    return _sum/static_cast<float>(N);
+}
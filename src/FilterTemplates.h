@@ -1,9 +1,12 @@
 #pragma once
 
+#include "Denormals.h"
+#include "FilterMath.h"
 #include <array>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
+#include <utility>
 
 /*!
 Templated variants of selected filters.
@@ -11,13 +14,25 @@ Templated variants of selected filters.
 
 /*!
 Filter abstract base class.
+
+Define LIBRARY_FILTERS_NO_VIRTUAL to make FilterBaseT an empty base class, see FilterBase in Filters.h.
 */
+#if defined(LIBRARY_FILTERS_NO_VIRTUAL)
+#define LIBRARY_FILTERS_VIRTUAL
+#define LIBRARY_FILTERS_OVERRIDE
+template <typename T>
+class FilterBaseT {
+};
+#else
+#define LIBRARY_FILTERS_VIRTUAL virtual
+#define LIBRARY_FILTERS_OVERRIDE override
 template <typename T>
 class FilterBaseT {
 public:
     virtual ~FilterBaseT() = default;
     virtual T filterVirtual(const T& input) = 0;
 };
+#endif
 
 
 /*!
@@ -30,13 +45,14 @@ public:
 public:
     inline void init(float k) { (void)k; }
     inline void reset() {}
+    inline void reset(const T& value) { (void)value; }
     inline void setToPassthrough() {}
     inline void setCutoffFrequency(float cutoffFrequencyHz, float dT) { (void)cutoffFrequencyHz; (void)dT; }
     inline void setCutoffFrequencyAndReset(float cutoffFrequencyHz, float dT) { (void)cutoffFrequencyHz; (void)dT; }
 
     inline T filter(const T& input) { return input; }
     inline T filter(const T& input, float dT) { (void)dT; return input; }
-    virtual T filterVirtual(const T& input) override { return filter(input); }
+    LIBRARY_FILTERS_VIRTUAL T filterVirtual(const T& input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
 };
 
 
@@ -52,13 +68,15 @@ public:
 public:
     inline void init(float k) { _k = k; reset(); }
     inline void reset() { _state = {}; }
+    //! Reset to the steady state for a constant input of value, so the first output is immediately valid
+    inline void reset(const T& value) { _state = value; }
     inline void setToPassthrough() { _k = 1.0F; reset(); }
 
     inline T filter(const T& input) {
         _state += _k*(input - _state); // equivalent to _state = _k*input + (1.0F - _k)*_state;
         return _state;
     }
-    virtual T filterVirtual(const T& input) override { return filter(input); }
+    LIBRARY_FILTERS_VIRTUAL T filterVirtual(const T& input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
 
     inline void setCutoffFrequency(float cutoffFrequencyHz, float dT) { _k = gainFromFrequency(cutoffFrequencyHz, dT); }
     inline void setCutoffFrequencyAndReset(float cutoffFrequencyHz, float dT) { _k = gainFromFrequency(cutoffFrequencyHz, dT); reset(); }
@@ -94,6 +112,7 @@ public:
 public:
     inline void init(float k) { _k = k; reset(); }
     inline void reset() { _state[0] = {}; _state[1] = {}; }
+    inline void reset(const T& value) { _state[0] = value; _state[1] = value; }
     inline void setToPassthrough() { _k = 1.0F; }
 
     inline T filter(const T& input) {
@@ -101,7 +120,7 @@ public:
         _state[0] += _k*(_state[1] - _state[0]);
         return _state[0];
     }
-    virtual T filterVirtual(const T& input) override { return filter(input); }
+    LIBRARY_FILTERS_VIRTUAL T filterVirtual(const T& input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
 
     inline void setCutoffFrequency(float cutoffFrequencyHz, float dT) { _k = gainFromFrequency(cutoffFrequencyHz, dT); }
     inline void setCutoffFrequencyAndReset(float cutoffFrequencyHz, float dT) { _k = gainFromFrequency(cutoffFrequencyHz, dT); reset(); }
@@ -134,6 +153,7 @@ public:
 public:
     inline void init(float k) { _k = k; reset(); }
     inline void reset() { _state[0] = {}; _state[1] = {}; _state[2] = {}; }
+    inline void reset(const T& value) { _state[0] = value; _state[1] = value; _state[2] = value; }
     inline void setToPassthrough() { _k = 1.0F; reset(); }
 
     inline T filter(const T& input) {
@@ -142,7 +162,7 @@ public:
         _state[0] += _k*(_state[1] - _state[0]);
         return _state[0];
     }
-    virtual T filterVirtual(const T& input) override { return filter(input); }
+    LIBRARY_FILTERS_VIRTUAL T filterVirtual(const T& input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
 
     inline void setCutoffFrequency(float cutoffFrequencyHz, float dT) { _k = gainFromFrequency(cutoffFrequencyHz, dT); }
     inline void setCutoffFrequencyAndReset(float cutoffFrequencyHz, float dT) { _k = gainFromFrequency(cutoffFrequencyHz, dT); reset(); }
@@ -163,6 +183,93 @@ protected:
 };
 
 
+/*!
+Power transfer filter of order N, ie N cascaded first order stages with a common gain.
+
+The cutoff correction 1/sqrt(2^(1/N) - 1) is calculated at compile time and the stages are unrolled using a fold expression.
+The block `filter()` function is software pipelined: stage s processes sample t - s, so the N stage updates in each
+iteration are independent of each other and do not stall on the sequential dependency between stages.
+*/
+template <typename T, size_t N>
+class PowerTransferFilterNT : public FilterBaseT<T> {
+    static_assert(N >= 1, "PowerTransferFilterNT order must be at least 1");
+public:
+    explicit PowerTransferFilterNT(float k) : _k(k) {}
+    PowerTransferFilterNT() : PowerTransferFilterNT(1.0F) {}
+    PowerTransferFilterNT(float cutoffFrequencyHz, float dT) : PowerTransferFilterNT(gainFromFrequency(cutoffFrequencyHz, dT)) {}
+public:
+    inline void init(float k) { _k = k; reset(); }
+    inline void reset() { _state.fill(T{}); }
+    inline void reset(const T& value) { _state.fill(value); }
+    inline void setToPassthrough() { _k = 1.0F; reset(); }
+
+    inline T filter(const T& input) { return filterStages(denormalOffset(input), std::make_index_sequence<N>{}); }
+    void filter(const T* input, T* output, size_t count);
+    LIBRARY_FILTERS_VIRTUAL T filterVirtual(const T& input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
+
+    inline void setCutoffFrequency(float cutoffFrequencyHz, float dT) { _k = gainFromFrequency(cutoffFrequencyHz, dT); }
+    inline void setCutoffFrequencyAndReset(float cutoffFrequencyHz, float dT) { _k = gainFromFrequency(cutoffFrequencyHz, dT); reset(); }
+    static inline float gainFromDelay(float delay, float dT) {
+        return PowerTransferFilter1T<T>::gainFromDelay(delay*cutoffCorrection, dT);
+    }
+    static inline float gainFromFrequency(float cutoffFrequencyHz, float dT) {
+        // shift cutoffFrequency to satisfy -3dB cutoff condition
+        return PowerTransferFilter1T<T>::gainFromFrequency(cutoffFrequencyHz*cutoffCorrection, dT);
+    }
+    static constexpr float getCutoffCorrection() { return cutoffCorrection; }
+// for testing
+    const std::array<T, N>& getState() const { return _state; }
+protected:
+    // _state[N-1] is the first stage and _state[0] is the last stage (the output)
+    template <size_t... I>
+    inline T filterStages(const T& input, std::index_sequence<I...>) {
+        T value = input;
+        ((value = _state[N-1-I] = denormalSnap(_state[N-1-I] + _k*(value - _state[N-1-I]))), ...);
+        return value;
+    }
+    // updating the last stage first means each stage reads its predecessor's output from the previous iteration
+    template <size_t... I>
+    inline T pipelineStages(const T& input, std::index_sequence<I...>) {
+        ((_state[I] = denormalSnap(_state[I] + _k*((I == N-1 ? input : _state[I < N-1 ? I+1 : I]) - _state[I]))), ...);
+        return _state[0];
+    }
+    inline void pipelineStages(const T& input, size_t begin, size_t end) {
+        for (size_t ii = begin; ii < end; ++ii) {
+            _state[ii] = denormalSnap(_state[ii] + _k*((ii == N-1 ? input : _state[ii+1]) - _state[ii]));
+        }
+    }
+protected:
+    // PowerTransferFilter<n> cutoff correction = 1/sqrt(2^(1/n) - 1)
+    static constexpr float cutoffCorrection = static_cast<float>(powerTransferCutoffCorrection(N));
+    float _k;
+    std::array<T, N> _state {};
+};
+
+template <typename T, size_t N>
+inline void PowerTransferFilterNT<T, N>::filter(const T* input, T* output, size_t count)
+{
+    if (count < N) {
+        for (size_t ii = 0; ii < count; ++ii) {
+            output[ii] = filter(input[ii]);
+        }
+        return;
+    }
+    // prologue, fill the pipeline: on iteration t only stages 0 to t are active
+    for (size_t t = 0; t < N - 1; ++t) {
+        pipelineStages(denormalOffset(input[t]), N - 1 - t, N);
+    }
+    // all stages active, the last stage outputs sample t - (N - 1)
+    for (size_t t = N - 1; t < count; ++t) {
+        output[t + 1 - N] = pipelineStages(denormalOffset(input[t]), std::make_index_sequence<N>{});
+    }
+    // epilogue, drain the pipeline: the first stage has no more input
+    for (size_t t = count; t < count + N - 1; ++t) {
+        pipelineStages(T{}, 0, count + N - 1 - t);
+        output[t + 1 - N] = _state[0];
+    }
+}
+
+
 /*!
 Biquad filter, see https://en.wikipedia.org/wiki/Digital_biquad_filter
 
@@ -209,17 +316,22 @@ public:
     }
 
     inline void reset() { _state.x1 = {}; _state.x2 = {}; _state.y1 = {}; _state.y2 = {}; }
+    //! Reset to the steady state for a constant input of value, using the DC gain of the filter
+    inline void reset(const T& value) { const T output = dcGain()*value; _state.x1 = value; _state.x2 = value; _state.y1 = output; _state.y2 = output; }
+    //! DC gain (b0 + b1 + b2)/(1 + a1 + a2), taken as 1 if the filter has a pole at DC
+    inline float dcGain() const { const float denominator = 1.0F + _a1 + _a2; return denominator == 0.0F ? 1.0F : (_b0 + _b1 + _b2)/denominator; }
     inline void setToPassthrough() { _b0 = 1.0F; _b1 = 0.0F; _b2 = 0.0F; _a1 = 0.0F; _a2 = 0.0F;  _weight = 1.0F; reset(); }
 
     inline T filter(const T& input) {
-        const T output = _b0*input + _b1*_state.x1 + _b2*_state.x2 - _a1*_state.y1 - _a2*_state.y2;
+        const T x = denormalOffset(input);
+        const T output = denormalSnap(_b0*x + _b1*_state.x1 + _b2*_state.x2 - _a1*_state.y1 - _a2*_state.y2);
         _state.x2 = _state.x1;
-        _state.x1 = input;
+        _state.x1 = x;
         _state.y2 = _state.y1;
         _state.y1 = output;
         return output;
     }
-    virtual T filterVirtual(const T& input) override { return filter(input); }
+    LIBRARY_FILTERS_VIRTUAL T filterVirtual(const T& input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
 
     inline T filterWeighted(const T& input) {
         const T output = filter(input);
@@ -343,6 +455,82 @@ inline void BiquadFilterT<T>::setNotchFrequencyWeighted(float sinOmega, float tw
 }
 
 
+/*!
+Band-limited differentiator, the derivative and a second order low-pass filter combined into a single biquad,
+see DifferentiatorFilter in Filters.h.
+*/
+template <typename T>
+class DifferentiatorFilterT : public FilterBaseT<T> {
+public:
+    DifferentiatorFilterT() = default;
+    DifferentiatorFilterT(float frequencyHz, float loopTimeSeconds, float Q) { init(frequencyHz, loopTimeSeconds, Q); }
+    struct state_t {
+        T x1;
+        T x2;
+        T y1;
+        T y2;
+    };
+public:
+    inline void reset() { _state.x1 = {}; _state.x2 = {}; _state.y1 = {}; _state.y2 = {}; }
+    //! Reset to the steady state for a constant input of value, which has zero derivative
+    inline void reset(const T& value) { _state.x1 = value; _state.x2 = value; _state.y1 = {}; _state.y2 = {}; }
+    //! No low-pass filtering, the output is the central difference (x - x2)/(2*dT)
+    inline void setToPassthrough() { _b0 = 0.5F*_loopTimeReciprocal; _a1 = 0.0F; _a2 = 0.0F; reset(); }
+
+    inline T filter(const T& input) {
+        const T x = denormalOffset(input);
+        const T output = denormalSnap(_b0*(x - _state.x2) - _a1*_state.y1 - _a2*_state.y2);
+        _state.x2 = _state.x1;
+        _state.x1 = x;
+        _state.y2 = _state.y1;
+        _state.y1 = output;
+        return output;
+    }
+    LIBRARY_FILTERS_VIRTUAL T filterVirtual(const T& input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
+    //! Returns the derivative of setpointWeight*setpoint - measurement
+    inline T filterSetpointWeighted(const T& setpoint, const T& measurement) { return filter(_setpointWeight*setpoint - measurement); }
+    void setSetpointWeight(float setpointWeight) { _setpointWeight = setpointWeight; }
+    float getSetpointWeight() const { return _setpointWeight; }
+
+    inline void init(float frequencyHz, float loopTimeSeconds, float Q) {
+        assert(Q != 0.0F && "Q cannot be zero");
+        setLoopTime(loopTimeSeconds);
+        setQ(Q);
+        setFrequency(frequencyHz);
+        reset();
+    }
+    inline void setFrequency(float frequencyHz) {
+        const float omega = frequencyHz*_2PiLoopTimeSeconds;
+        const float cosOmega = cosf(omega);
+        const float alpha = sinf(omega)*_2Q_reciprocal;
+        const float a0reciprocal = 1.0F/(1.0F + alpha);
+        // band-pass b0 = alpha/a0, scaled so the response to a ramp of slope 1 is 1
+        _b0 = (1.0F - cosOmega)*a0reciprocal*_loopTimeReciprocal;
+        _a1 = -2.0F*cosOmega*a0reciprocal;
+        _a2 = (1.0F - alpha)*a0reciprocal;
+    }
+    void setQ(float Q) { _2Q_reciprocal = 1.0F /(2.0F*Q); }
+    float getQ() const { return (1.0F/_2Q_reciprocal)/2.0F; }
+
+    void setLoopTime(float loopTimeSeconds) { _2PiLoopTimeSeconds = 2.0F*PI_F*loopTimeSeconds; _loopTimeReciprocal = 1.0F/loopTimeSeconds; }
+// for testing
+    const state_t& getState() const { return _state; }
+protected:
+    float _b0 {0.5F};
+    float _a1 {0.0F};
+    float _a2 {0.0F};
+    float _setpointWeight {1.0F};
+
+    state_t _state {};
+
+    float _2Q_reciprocal {1.0F}; // store 1/(2*Q), since that is what is used in setFrequency calculations
+    float _2PiLoopTimeSeconds {0.0F}; // store 2*PI*loopTimeSeconds, since that is what is used in calculations
+    float _loopTimeReciprocal {1.0F};
+protected:
+    static constexpr float PI_F = 3.14159265358979323846F;
+};
+
+
 /*!
 Simple moving average filter.
 */
@@ -352,10 +540,12 @@ public:
     FilterMovingAverageT() {} // cppcheck-suppress uninitMemberVar
 public:
     inline void reset() { _sum = {}; _count = 0; _index = 0;}
+    //! Fill the window with value, so the average is immediately value
+    inline void reset(const T& value) { for (T& sample : _samples) { sample = value; } _sum = value*static_cast<float>(N); _count = N; _index = 0; }
 
     inline T filter(const T& input);
     inline T filter(const T& input, float dT) { (void)dT; return filter(input); }
-    virtual T filterVirtual(const T& input) override { return filter(input); }
+    LIBRARY_FILTERS_VIRTUAL T filterVirtual(const T& input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
 protected:
     size_t _count {0};
     size_t _index {0};
@@ -1,19 +1,35 @@
 #pragma once
 
+#include "Denormals.h"
+#include "FilterMath.h"
 #include <algorithm>
 #include <array>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
+#include <utility>
 
 /*!
 Filter abstract base class.
+
+Define LIBRARY_FILTERS_NO_VIRTUAL to make FilterBase an empty base class.
+The filters then have no vtable pointer, are standard-layout and trivially copyable,
+and `filterVirtual` becomes an ordinary (non-virtual) member function.
 */
+#if defined(LIBRARY_FILTERS_NO_VIRTUAL)
+#define LIBRARY_FILTERS_VIRTUAL
+#define LIBRARY_FILTERS_OVERRIDE
+class FilterBase {
+};
+#else
+#define LIBRARY_FILTERS_VIRTUAL virtual
+#define LIBRARY_FILTERS_OVERRIDE override
 class FilterBase {
 public:
     virtual ~FilterBase() = default;
     virtual float filterVirtual(float input) = 0;
 };
+#endif
 
 
 /*!
@@ -25,13 +41,14 @@ public:
 public:
     inline void init(float k) { (void)k; }
     inline void reset() {}
+    inline void reset(float value) { (void)value; }
     inline void setToPassthrough() {}
     inline void setCutoffFrequency(float cutoffFrequencyHz, float dT) { (void)cutoffFrequencyHz; (void)dT; }
     inline void setCutoffFrequencyAndReset(float cutoffFrequencyHz, float dT) { (void)cutoffFrequencyHz; (void)dT; }
 
     inline float filter(float input) { return input; }
     inline float filter(float input, float dT) { (void)dT; return input; }
-    virtual float filterVirtual(float input) override { return filter(input); }
+    LIBRARY_FILTERS_VIRTUAL float filterVirtual(float input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
 };
 
 
@@ -46,13 +63,15 @@ public:
 public:
     inline void init(float k) { _k = k; reset(); }
     inline void reset() { _state = 0.0F; }
+    //! Reset to the steady state for a constant input of value, so the first output is immediately valid
+    inline void reset(float value) { _state = value; }
     inline void setToPassthrough() { _k = 1.0F; reset(); }
 
     inline float filter(float input) {
         _state += _k*(input - _state); // equivalent to _state = _k*input + (1.0F - _k)*_state;
         return _state;
     }
-    virtual float filterVirtual(float input) override { return filter(input); }
+    LIBRARY_FILTERS_VIRTUAL float filterVirtual(float input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
 
     inline void setCutoffFrequency(float cutoffFrequencyHz, float dT) { _k = gainFromFrequency(cutoffFrequencyHz, dT); }
     inline void setCutoffFrequencyAndReset(float cutoffFrequencyHz, float dT) { _k = gainFromFrequency(cutoffFrequencyHz, dT); reset(); }
@@ -87,6 +106,7 @@ public:
 public:
     inline void init(float k) { _k = k; reset(); }
     inline void reset() { _state[0] = 0.0F; _state[1] = 0.0F; }
+    inline void reset(float value) { _state[0] = value; _state[1] = value; }
     inline void setToPassthrough() { _k = 1.0F; }
 
     inline float filter(float input) {
@@ -94,7 +114,7 @@ public:
         _state[0] += _k*(_state[1] - _state[0]);
         return _state[0];
     }
-    virtual float filterVirtual(float input) override { return filter(input); }
+    LIBRARY_FILTERS_VIRTUAL float filterVirtual(float input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
 
     inline void setCutoffFrequency(float cutoffFrequencyHz, float dT) { _k = gainFromFrequency(cutoffFrequencyHz, dT); }
     inline void setCutoffFrequencyAndReset(float cutoffFrequencyHz, float dT) { _k = gainFromFrequency(cutoffFrequencyHz, dT); reset(); }
@@ -126,6 +146,7 @@ public:
 public:
     inline void init(float k) { _k = k; reset(); }
     inline void reset() { _state[0] = 0.0F; _state[1] = 0.0F; _state[2] = 0.0F; }
+    inline void reset(float value) { _state[0] = value; _state[1] = value; _state[2] = value; }
     inline void setToPassthrough() { _k = 1.0F; reset(); }
 
     inline float filter(float input) {
@@ -134,7 +155,7 @@ public:
         _state[0] += _k*(_state[1] - _state[0]);
         return _state[0];
     }
-    virtual float filterVirtual(float input) override { return filter(input); }
+    LIBRARY_FILTERS_VIRTUAL float filterVirtual(float input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
 
     inline void setCutoffFrequency(float cutoffFrequencyHz, float dT) { _k = gainFromFrequency(cutoffFrequencyHz, dT); }
     inline void setCutoffFrequencyAndReset(float cutoffFrequencyHz, float dT) { _k = gainFromFrequency(cutoffFrequencyHz, dT); reset(); }
@@ -155,6 +176,93 @@ protected:
 };
 
 
+/*!
+Power transfer filter of order N, ie N cascaded first order stages with a common gain.
+
+The cutoff correction 1/sqrt(2^(1/N) - 1) is calculated at compile time and the stages are unrolled using a fold expression.
+The block `filter()` function is software pipelined: stage s processes sample t - s, so the N stage updates in each
+iteration are independent of each other and do not stall on the sequential dependency between stages.
+*/
+template <size_t N>
+class PowerTransferFilterN : public FilterBase {
+    static_assert(N >= 1, "PowerTransferFilterN order must be at least 1");
+public:
+    explicit PowerTransferFilterN(float k) : _k(k) {}
+    PowerTransferFilterN() : PowerTransferFilterN(1.0F) {}
+    PowerTransferFilterN(float cutoffFrequencyHz, float dT) : PowerTransferFilterN(gainFromFrequency(cutoffFrequencyHz, dT)) {}
+public:
+    inline void init(float k) { _k = k; reset(); }
+    inline void reset() { _state.fill(0.0F); }
+    inline void reset(float value) { _state.fill(value); }
+    inline void setToPassthrough() { _k = 1.0F; reset(); }
+
+    inline float filter(float input) { return filterStages(denormalOffset(input), std::make_index_sequence<N>{}); }
+    void filter(const float* input, float* output, size_t count);
+    LIBRARY_FILTERS_VIRTUAL float filterVirtual(float input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
+
+    inline void setCutoffFrequency(float cutoffFrequencyHz, float dT) { _k = gainFromFrequency(cutoffFrequencyHz, dT); }
+    inline void setCutoffFrequencyAndReset(float cutoffFrequencyHz, float dT) { _k = gainFromFrequency(cutoffFrequencyHz, dT); reset(); }
+    static inline float gainFromDelay(float delay, float dT) {
+        return PowerTransferFilter1::gainFromDelay(delay*cutoffCorrection, dT);
+    }
+    static inline float gainFromFrequency(float cutoffFrequencyHz, float dT) {
+        // shift cutoffFrequency to satisfy -3dB cutoff condition
+        return PowerTransferFilter1::gainFromFrequency(cutoffFrequencyHz*cutoffCorrection, dT);
+    }
+    static constexpr float getCutoffCorrection() { return cutoffCorrection; }
+    friend class SnapshotAccess; // for saveSnapshot() and loadSnapshot(), see Snapshot.h
+// for testing
+    const std::array<float, N>& getState() const { return _state; }
+protected:
+    // _state[N-1] is the first stage and _state[0] is the last stage (the output)
+    template <size_t... I>
+    inline float filterStages(float input, std::index_sequence<I...>) {
+        float value = input;
+        ((value = _state[N-1-I] = denormalSnap(_state[N-1-I] + _k*(value - _state[N-1-I]))), ...);
+        return value;
+    }
+    // updating the last stage first means each stage reads its predecessor's output from the previous iteration
+    template <size_t... I>
+    inline float pipelineStages(float input, std::index_sequence<I...>) {
+        ((_state[I] = denormalSnap(_state[I] + _k*((I == N-1 ? input : _state[I < N-1 ? I+1 : I]) - _state[I]))), ...);
+        return _state[0];
+    }
+    inline void pipelineStages(float input, size_t begin, size_t end) {
+        for (size_t ii = begin; ii < end; ++ii) {
+            _state[ii] = denormalSnap(_state[ii] + _k*((ii == N-1 ? input : _state[ii+1]) - _state[ii]));
+        }
+    }
+protected:
+    // PowerTransferFilter<n> cutoff correction = 1/sqrt(2^(1/n) - 1)
+    static constexpr float cutoffCorrection = static_cast<float>(powerTransferCutoffCorrection(N));
+    float _k;
+    std::array<float, N> _state {};
+};
+
+template <size_t N>
+inline void PowerTransferFilterN<N>::filter(const float* input, float* output, size_t count)
+{
+    if (count < N) {
+        for (size_t ii = 0; ii < count; ++ii) {
+            output[ii] = filter(input[ii]);
+        }
+        return;
+    }
+    // prologue, fill the pipeline: on iteration t only stages 0 to t are active
+    for (size_t t = 0; t < N - 1; ++t) {
+        pipelineStages(denormalOffset(input[t]), N - 1 - t, N);
+    }
+    // all stages active, the last stage outputs sample t - (N - 1)
+    for (size_t t = N - 1; t < count; ++t) {
+        output[t + 1 - N] = pipelineStages(denormalOffset(input[t]), std::make_index_sequence<N>{});
+    }
+    // epilogue, drain the pipeline: the first stage has no more input
+    for (size_t t = count; t < count + N - 1; ++t) {
+        pipelineStages(0.0F, 0, count + N - 1 - t);
+        output[t + 1 - N] = _state[0];
+    }
+}
+
 /*!
 Biquad filter, see https://en.wikipedia.org/wiki/Digital_biquad_filter
 
@@ -200,17 +308,22 @@ public:
     }
 
     inline void reset() { _state.x1 = 0.0F; _state.x2 = 0.0F; _state.y1 = 0.0F; _state.y2 = 0.0F; }
+    //! Reset to the steady state for a constant input of value, using the DC gain of the filter
+    inline void reset(float value) { const float output = dcGain()*value; _state.x1 = value; _state.x2 = value; _state.y1 = output; _state.y2 = output; }
+    //! DC gain (b0 + b1 + b2)/(1 + a1 + a2), taken as 1 if the filter has a pole at DC
+    inline float dcGain() const { const float denominator = 1.0F + _a1 + _a2; return denominator == 0.0F ? 1.0F : (_b0 + _b1 + _b2)/denominator; }
     inline void setToPassthrough() { _b0 = 1.0F; _b1 = 0.0F; _b2 = 0.0F; _a1 = 0.0F; _a2 = 0.0F;  _weight = 1.0F; reset(); }
 
     inline float filter(float input) {
-        const float output = _b0*input + _b1*_state.x1 + _b2*_state.x2 - _a1*_state.y1 - _a2*_state.y2;
+        const float x = denormalOffset(input);
+        const float output = denormalSnap(_b0*x + _b1*_state.x1 + _b2*_state.x2 - _a1*_state.y1 - _a2*_state.y2);
         _state.x2 = _state.x1;
-        _state.x1 = input;
+        _state.x1 = x;
         _state.y2 = _state.y1;
         _state.y1 = output;
         return output;
     }
-    virtual float filterVirtual(float input) override { return filter(input); }
+    LIBRARY_FILTERS_VIRTUAL float filterVirtual(float input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
 
     inline float filterWeighted(float input) {
         const float output = filter(input);
@@ -257,6 +370,7 @@ public:
     float getQ() const { return (1.0F/_2Q_reciprocal)/2.0F; }
 
     void setLoopTime(float loopTimeSeconds) { _2PiLoopTimeSeconds = 2.0F*PI_F*loopTimeSeconds; }
+
 // for testing
     const state_t& getState() const { return _state; }
 protected:
@@ -273,6 +387,8 @@ protected:
     float _2PiLoopTimeSeconds {0.0F}; // store 2*PI*loopTimeSeconds, since that is what is used in calculations
 protected:
     static constexpr float PI_F = 3.14159265358979323846F;
+    friend class BiquadFilterShared;
+    friend class SnapshotAccess; // for saveSnapshot() and loadSnapshot(), see Snapshot.h
 };
 
 /*!
@@ -344,6 +460,212 @@ inline void BiquadFilter::setNotchFrequencyWeighted(float sinOmega, float two_co
     _a2 = (1.0F - alpha)*a0reciprocal;
 }
 
+/*!
+Biquad filter that shares its coefficients with other instances.
+
+The coefficients are held in a `BiquadFilter`, which is referenced rather than copied, so each instance stores only its state
+and a pointer to the coefficients. Retuning the referenced filter, eg with `setNotchFrequency()`, retunes every instance that shares it.
+The state of the referenced filter itself is not used.
+
+Does not derive from FilterBase, so instances have no vtable pointer.
+*/
+class BiquadFilterShared {
+public:
+    explicit BiquadFilterShared(const BiquadFilter& coefficients) : _coefficients(&coefficients) {}
+    BiquadFilterShared() = default;
+    using state_t = BiquadFilter::state_t;
+public:
+    inline void setCoefficients(const BiquadFilter& coefficients) { _coefficients = &coefficients; }
+    inline const BiquadFilter& getCoefficients() const { return *_coefficients; }
+
+    inline void reset() { _state.x1 = 0.0F; _state.x2 = 0.0F; _state.y1 = 0.0F; _state.y2 = 0.0F; }
+    inline void reset(float value) { const float output = _coefficients->dcGain()*value; _state.x1 = value; _state.x2 = value; _state.y1 = output; _state.y2 = output; }
+
+    inline float filter(float input) {
+        const BiquadFilter& c = *_coefficients;
+        const float x = denormalOffset(input);
+        const float output = denormalSnap(c._b0*x + c._b1*_state.x1 + c._b2*_state.x2 - c._a1*_state.y1 - c._a2*_state.y2);
+        _state.x2 = _state.x1;
+        _state.x1 = x;
+        _state.y2 = _state.y1;
+        _state.y1 = output;
+        return output;
+    }
+    inline float filterWeighted(float input) {
+        const float output = filter(input);
+        // weight of 1.0 gives just output, weight of 0.0 gives just input
+        return _coefficients->_weight*(output - input) + input;
+    }
+// for testing
+    const state_t& getState() const { return _state; }
+protected:
+    const BiquadFilter* _coefficients {nullptr};
+    state_t _state {};
+};
+
+
+/*!
+State variable filter, using the topology-preserving (trapezoidal integrator) form,
+see [Andrew Simper, Linear Trapezoidal Integrated SVF](https://cytomic.com/files/dsp/SvfLinearTrapOptimised2.pdf).
+
+A single state update gives low-pass, band-pass, high-pass, and notch outputs.
+
+The coefficients depend only on `g = tan(PI*frequency*loopTime)` and `1/Q`, so the cutoff may be changed every sample
+without the instability that retuning a direct form biquad can cause.
+`setFrequencyFromTan()` allows `g` to be supplied directly, eg from a lookup table, avoiding the call to `tanf`.
+*/
+class StateVariableFilter : public FilterBase {
+public:
+    StateVariableFilter() = default;
+    struct outputs_t {
+        float lowPass;
+        float bandPass;
+        float highPass;
+        float notch;
+    };
+    struct state_t {
+        float ic1eq;
+        float ic2eq;
+    };
+public:
+    inline void reset() { _state.ic1eq = 0.0F; _state.ic2eq = 0.0F; }
+    //! Reset to the steady state for a constant input of value: the low-pass integrator holds value and the band-pass integrator is zero
+    inline void reset(float value) { _state.ic1eq = 0.0F; _state.ic2eq = value; }
+    // g -> infinity limit, low-pass and notch outputs equal the input
+    inline void setToPassthrough() { _a1 = 0.0F; _a2 = 0.0F; _a3 = 1.0F; reset(); }
+
+    inline outputs_t filterOutputs(float input) {
+        const float v3 = input - _state.ic2eq;
+        const float v1 = _a1*_state.ic1eq + _a2*v3;
+        const float v2 = _state.ic2eq + _a2*_state.ic1eq + _a3*v3;
+        _state.ic1eq = 2.0F*v1 - _state.ic1eq;
+        _state.ic2eq = 2.0F*v2 - _state.ic2eq;
+        const float notch = input - _k*v1;
+        return outputs_t { v2, v1, notch - v2, notch };
+    }
+    //! Returns the low-pass output
+    inline float filter(float input) { return filterOutputs(input).lowPass; }
+    LIBRARY_FILTERS_VIRTUAL float filterVirtual(float input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
+    inline float filterNotch(float input) { return filterOutputs(input).notch; }
+
+    inline void init(float frequencyHz, float loopTimeSeconds, float Q) {
+        assert(Q != 0.0F && "Q cannot be zero");
+        setLoopTime(loopTimeSeconds);
+        _k = 1.0F/Q;
+        setFrequency(frequencyHz);
+        reset();
+    }
+    inline void setFrequency(float frequencyHz) { setFrequencyFromTan(tanf(frequencyHz*_piLoopTimeSeconds)); }
+    //! Set the frequency using g = tan(PI*frequency*loopTime), which may be obtained from a lookup table.
+    inline void setFrequencyFromTan(float g) {
+        _g = g;
+        _a1 = 1.0F/(1.0F + g*(g + _k));
+        _a2 = g*_a1;
+        _a3 = g*_a2;
+    }
+    inline void setQ(float Q) { _k = 1.0F/Q; setFrequencyFromTan(_g); }
+    float getQ() const { return 1.0F/_k; }
+
+    void setLoopTime(float loopTimeSeconds) { _piLoopTimeSeconds = PI_F*loopTimeSeconds; }
+    inline float calculateTan(float frequencyHz) const { return tanf(frequencyHz*_piLoopTimeSeconds); }
+// for testing
+    const state_t& getState() const { return _state; }
+protected:
+    float _a1 {0.0F};
+    float _a2 {0.0F};
+    float _a3 {1.0F};
+    float _k {1.0F}; // 1/Q
+    float _g {0.0F}; // tan(PI*frequency*loopTime)
+
+    state_t _state {};
+
+    float _piLoopTimeSeconds {0.0F}; // store PI*loopTimeSeconds, since that is what is used in setFrequency calculations
+protected:
+    static constexpr float PI_F = 3.14159265358979323846F;
+};
+
+
+/*!
+Band-limited differentiator, eg for the PID D-term: the derivative and a second order low-pass filter combined into a single biquad,
+so there is one state update per sample, rather than `(x - xPrevious)/dT` followed by a separate low-pass filter.
+
+The filter is the RBJ band-pass filter scaled by omega0*Q, so it has transfer function
+H(z) = b0*(1 - z^-2)/(1 + a1*z^-1 + a2*z^-2), which is the derivative well below the cutoff frequency, rolling off above it.
+The numerator has only one coefficient, so each sample takes three multiplies.
+
+`filterSetpointWeighted()` differentiates weight*setpoint - measurement, so with a weight of 0 the derivative
+is of the measurement only, avoiding "derivative kick" on setpoint changes.
+*/
+class DifferentiatorFilter : public FilterBase {
+public:
+    DifferentiatorFilter() = default;
+    DifferentiatorFilter(float frequencyHz, float loopTimeSeconds, float Q) { init(frequencyHz, loopTimeSeconds, Q); }
+    struct state_t {
+        float x1;
+        float x2;
+        float y1;
+        float y2;
+    };
+public:
+    inline void reset() { _state.x1 = 0.0F; _state.x2 = 0.0F; _state.y1 = 0.0F; _state.y2 = 0.0F; }
+    //! Reset to the steady state for a constant input of value, which has zero derivative
+    inline void reset(float value) { _state.x1 = value; _state.x2 = value; _state.y1 = 0.0F; _state.y2 = 0.0F; }
+    //! No low-pass filtering, the output is the central difference (x - x2)/(2*dT)
+    inline void setToPassthrough() { _b0 = 0.5F*_loopTimeReciprocal; _a1 = 0.0F; _a2 = 0.0F; reset(); }
+
+    inline float filter(float input) {
+        const float x = denormalOffset(input);
+        const float output = denormalSnap(_b0*(x - _state.x2) - _a1*_state.y1 - _a2*_state.y2);
+        _state.x2 = _state.x1;
+        _state.x1 = x;
+        _state.y2 = _state.y1;
+        _state.y1 = output;
+        return output;
+    }
+    LIBRARY_FILTERS_VIRTUAL float filterVirtual(float input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
+    //! Returns the derivative of setpointWeight*setpoint - measurement
+    inline float filterSetpointWeighted(float setpoint, float measurement) { return filter(_setpointWeight*setpoint - measurement); }
+    void setSetpointWeight(float setpointWeight) { _setpointWeight = setpointWeight; }
+    float getSetpointWeight() const { return _setpointWeight; }
+
+    inline void init(float frequencyHz, float loopTimeSeconds, float Q) {
+        assert(Q != 0.0F && "Q cannot be zero");
+        setLoopTime(loopTimeSeconds);
+        setQ(Q);
+        setFrequency(frequencyHz);
+        reset();
+    }
+    inline void setFrequency(float frequencyHz) {
+        const float omega = frequencyHz*_2PiLoopTimeSeconds;
+        const float cosOmega = cosf(omega);
+        const float alpha = sinf(omega)*_2Q_reciprocal;
+        const float a0reciprocal = 1.0F/(1.0F + alpha);
+        // band-pass b0 = alpha/a0, scaled so the response to a ramp of slope 1 is 1
+        _b0 = (1.0F - cosOmega)*a0reciprocal*_loopTimeReciprocal;
+        _a1 = -2.0F*cosOmega*a0reciprocal;
+        _a2 = (1.0F - alpha)*a0reciprocal;
+    }
+    void setQ(float Q) { _2Q_reciprocal = 1.0F /(2.0F*Q); }
+    float getQ() const { return (1.0F/_2Q_reciprocal)/2.0F; }
+
+    void setLoopTime(float loopTimeSeconds) { _2PiLoopTimeSeconds = 2.0F*PI_F*loopTimeSeconds; _loopTimeReciprocal = 1.0F/loopTimeSeconds; }
+// for testing
+    const state_t& getState() const { return _state; }
+protected:
+    float _b0 {0.5F};
+    float _a1 {0.0F};
+    float _a2 {0.0F};
+    float _setpointWeight {1.0F};
+
+    state_t _state {};
+
+    float _2Q_reciprocal {1.0F}; // store 1/(2*Q), since that is what is used in setFrequency calculations
+    float _2PiLoopTimeSeconds {0.0F}; // store 2*PI*loopTimeSeconds, since that is what is used in calculations
+    float _loopTimeReciprocal {1.0F};
+protected:
+    static constexpr float PI_F = 3.14159265358979323846F;
+};
+
 
 /*!
 Simple moving average filter.
@@ -355,10 +677,13 @@ public:
     FilterMovingAverage() {} // cppcheck-suppress uninitMemberVar
 public:
     inline void reset() { _sum = 0.0F; _count = 0; _index = 0;}
+    //! Fill the window with value, so the average is immediately value
+    inline void reset(float value) { for (float& sample : _samples) { sample = value; } _sum = value*static_cast<float>(N); _count = N; _index = 0; }
 
     inline float filter(float input);
     inline float filter(float input, float dT) { (void)dT; return filter(input); }
-    virtual float filterVirtual(float input) override { return filter(input); }
+    LIBRARY_FILTERS_VIRTUAL float filterVirtual(float input) LIBRARY_FILTERS_OVERRIDE { return filter(input); }
+    friend class SnapshotAccess; // for saveSnapshot() and loadSnapshot(), see Snapshot.h
 protected:
     size_t _count {0};
     size_t _index {0};
@@ -384,3 +709,4 @@ inline float FilterMovingAverage<N>::filter(float input)
     constexpr float nReciprocal = 1.0F/N;
     return _sum*nReciprocal;
 }
+
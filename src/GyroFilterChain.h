@@ -0,0 +1,259 @@
+#pragma once
+
+#include "Filters.h"
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(LIBRARY_FILTERS_NO_SIMD)
+#if defined(__SSE__) || defined(__x86_64__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define LIBRARY_FILTERS_HAS_SSE
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define LIBRARY_FILTERS_HAS_NEON
+#endif
+#endif
+
+
+/*!
+Fused gyro filter chain: a PowerTransferFilter1, two static notch filters, and DYNAMIC_NOTCH_COUNT dynamic notch filters,
+applied to all three axes in a single loop body.
+
+The coefficients and state of every stage are held in one struct, in structure-of-arrays form with one lane per axis,
+padded to 4 lanes, eg the b0 coefficients of a notch for x, y, z, and padding are contiguous.
+So each stage is a few 4-lane multiply-adds, written with SSE or NEON intrinsics, rather than each axis of each filter
+loading and storing its own state. Where neither is available, or LIBRARY_FILTERS_NO_SIMD is defined,
+the stages are scalar code on the 3 axis lanes, which gains much less over separate filters.
+The timings are reported by the test_gyro_filter_chain_timing benchmark.
+
+The notch filters are biquads with b1 == a1, so each sample takes 4 multiplies rather than 5.
+(b2 is stored separately from b0, although they are equal for a notch, so that a stage can also be set to passthrough.)
+
+Each stage may be enabled and disabled at run time, disabled stages are skipped. A stage's state is reset when it is enabled,
+so stale state does not cause a transient.
+*/
+template <size_t DYNAMIC_NOTCH_COUNT = 3>
+class GyroFilterChain {
+public:
+    static constexpr size_t AXIS_COUNT = 3;
+    static constexpr size_t LANES = 4;
+    static constexpr size_t STATIC_NOTCH_COUNT = 2;
+    static_assert(STATIC_NOTCH_COUNT + DYNAMIC_NOTCH_COUNT < 32, "GyroFilterChain has too many notches");
+    enum stage_e : uint32_t { POWER_TRANSFER = 0, STATIC_NOTCH_0 = 1, STATIC_NOTCH_1 = 2, DYNAMIC_NOTCH_0 = 3 };
+    static constexpr size_t STAGE_COUNT = 1 + STATIC_NOTCH_COUNT + DYNAMIC_NOTCH_COUNT;
+    using lanes_t = std::array<float, LANES>;
+    struct alignas(16) power_transfer_t {
+        lanes_t k;
+        lanes_t state;
+    };
+    //! Notch biquad, b1 == a1
+    struct alignas(16) notch_t {
+        lanes_t b0;
+        lanes_t b2;
+        lanes_t a1;
+        lanes_t a2;
+        lanes_t x1;
+        lanes_t x2;
+        lanes_t y1;
+        lanes_t y2;
+    };
+    struct alignas(16) stages_t {
+        power_transfer_t powerTransfer;
+        std::array<notch_t, STATIC_NOTCH_COUNT + DYNAMIC_NOTCH_COUNT> notches; //!< static notches first, then dynamic notches
+    };
+public:
+    GyroFilterChain() { setToPassthrough(); }
+    explicit GyroFilterChain(float loopTimeSeconds) : GyroFilterChain() { setLoopTime(loopTimeSeconds); }
+public:
+    void setLoopTime(float loopTimeSeconds) { _loopTimeSeconds = loopTimeSeconds; _2PiLoopTimeSeconds = 2.0F*PI_F*loopTimeSeconds; }
+    //! Sets every stage, on every axis, to passthrough, and disables it. An enabled stage with passthrough coefficients outputs its input.
+    void setToPassthrough();
+    void reset();
+    void resetStage(size_t stage);
+
+    inline void setStageEnabled(size_t stage, bool enabled) {
+        assert(stage < STAGE_COUNT);
+        const uint32_t bit = 1U << stage;
+        if (enabled && !(_enabledStages & bit)) {
+            resetStage(stage);
+        }
+        _enabledStages = enabled ? (_enabledStages | bit) : (_enabledStages & ~bit);
+    }
+    inline bool isStageEnabled(size_t stage) const { return (_enabledStages & (1U << stage)) != 0; }
+
+    //! Sets the cutoff frequency of the PowerTransferFilter1 stage, for all axes.
+    void setPowerTransferCutoffFrequency(float cutoffFrequencyHz) {
+        const float k = PowerTransferFilter1::gainFromFrequency(cutoffFrequencyHz, _loopTimeSeconds);
+        _stages.powerTransfer.k.fill(k);
+    }
+    //! Sets the frequency and Q of static notch index (0 or 1), for all axes.
+    void setStaticNotchFrequency(size_t index, float frequencyHz, float Q) {
+        assert(index < STATIC_NOTCH_COUNT);
+        for (size_t axis = 0; axis < AXIS_COUNT; ++axis) {
+            setNotchFrequency(_stages.notches[index], axis, frequencyHz, Q);
+        }
+    }
+    //! Sets the frequency of dynamic notch index on one axis, without resetting its state, so it may be called every loop.
+    void setDynamicNotchFrequency(size_t index, size_t axis, float frequencyHz) {
+        assert(index < DYNAMIC_NOTCH_COUNT && axis < AXIS_COUNT);
+        setNotchFrequency(_stages.notches[STATIC_NOTCH_COUNT + index], axis, frequencyHz, _dynamicNotchQ);
+    }
+    void setDynamicNotchQ(float Q) { assert(Q != 0.0F && "Q cannot be zero"); _dynamicNotchQ = Q; }
+    float getDynamicNotchQ() const { return _dynamicNotchQ; }
+
+    //! Filters one sample of each axis, input and output are {x, y, z}.
+    inline void filter(const float* input, float* output);
+    //! Filters a block of sampleCount samples, stored {x, y, z} interleaved, ie axis a of sample i is at input[i*3 + a].
+    inline void filter(const float* input, float* output, size_t sampleCount) {
+        for (size_t ii = 0; ii < sampleCount; ++ii) {
+            filter(input + ii*AXIS_COUNT, output + ii*AXIS_COUNT);
+        }
+    }
+// for testing
+    const stages_t& getStages() const { return _stages; }
+private:
+    void setNotchFrequency(notch_t& notch, size_t axis, float frequencyHz, float Q);
+    // lane operations, on SSE or NEON vectors, or on the 3 axis lanes
+#if defined(LIBRARY_FILTERS_HAS_SSE)
+    using vector_t = __m128;
+    static inline vector_t load(const lanes_t& a) { return _mm_load_ps(&a[0]); }
+    static inline vector_t set(float x, float y, float z) { return _mm_set_ps(0.0F, z, y, x); }
+    static inline void store(lanes_t& a, vector_t v) { _mm_store_ps(&a[0], v); }
+    static inline vector_t add(vector_t a, vector_t b) { return _mm_add_ps(a, b); }
+    static inline vector_t sub(vector_t a, vector_t b) { return _mm_sub_ps(a, b); }
+    static inline vector_t mul(vector_t a, vector_t b) { return _mm_mul_ps(a, b); }
+    static inline vector_t snap(vector_t v) {
+#if defined(LIBRARY_FILTERS_USE_DENORMAL_SNAP)
+        // clear the lanes whose magnitude is below the threshold
+        const vector_t magnitude = _mm_andnot_ps(_mm_set1_ps(-0.0F), v);
+        return _mm_and_ps(v, _mm_cmpge_ps(magnitude, _mm_set1_ps(DENORMAL_SNAP_THRESHOLD)));
+#else
+        return v;
+#endif
+    }
+#elif defined(LIBRARY_FILTERS_HAS_NEON)
+    using vector_t = float32x4_t;
+    static inline vector_t load(const lanes_t& a) { return vld1q_f32(&a[0]); }
+    static inline vector_t set(float x, float y, float z) { return vsetq_lane_f32(z, vsetq_lane_f32(y, vsetq_lane_f32(x, vdupq_n_f32(0.0F), 0), 1), 2); }
+    static inline void store(lanes_t& a, vector_t v) { vst1q_f32(&a[0], v); }
+    static inline vector_t add(vector_t a, vector_t b) { return vaddq_f32(a, b); }
+    static inline vector_t sub(vector_t a, vector_t b) { return vsubq_f32(a, b); }
+    static inline vector_t mul(vector_t a, vector_t b) { return vmulq_f32(a, b); }
+    static inline vector_t snap(vector_t v) {
+#if defined(LIBRARY_FILTERS_USE_DENORMAL_SNAP)
+        // clear the lanes whose magnitude is below the threshold
+        const uint32x4_t keep = vcgeq_f32(vabsq_f32(v), vdupq_n_f32(DENORMAL_SNAP_THRESHOLD));
+        return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(v), keep));
+#else
+        return v;
+#endif
+    }
+#else
+    using vector_t = std::array<float, AXIS_COUNT>;
+    static inline vector_t load(const lanes_t& a) { return vector_t {{ a[0], a[1], a[2] }}; }
+    static inline vector_t set(float x, float y, float z) { return vector_t {{ x, y, z }}; }
+    static inline void store(lanes_t& a, const vector_t& v) { a[0] = v[0]; a[1] = v[1]; a[2] = v[2]; }
+    static inline vector_t add(const vector_t& a, const vector_t& b) { return vector_t {{ a[0] + b[0], a[1] + b[1], a[2] + b[2] }}; }
+    static inline vector_t sub(const vector_t& a, const vector_t& b) { return vector_t {{ a[0] - b[0], a[1] - b[1], a[2] - b[2] }}; }
+    static inline vector_t mul(const vector_t& a, const vector_t& b) { return vector_t {{ a[0]*b[0], a[1]*b[1], a[2]*b[2] }}; }
+    static inline vector_t snap(const vector_t& v) { return vector_t {{ denormalSnap(v[0]), denormalSnap(v[1]), denormalSnap(v[2]) }}; }
+#endif
+private:
+    stages_t _stages {};
+    uint32_t _enabledStages {0};
+    float _dynamicNotchQ {3.0F};
+    float _loopTimeSeconds {0.0F};
+    float _2PiLoopTimeSeconds {0.0F}; // store 2*PI*loopTimeSeconds, since that is what is used in calculations
+    static constexpr float PI_F = 3.14159265358979323846F;
+};
+
+template <size_t DYNAMIC_NOTCH_COUNT>
+void GyroFilterChain<DYNAMIC_NOTCH_COUNT>::setToPassthrough()
+{
+    _stages.powerTransfer.k.fill(1.0F);
+    for (notch_t& notch : _stages.notches) {
+        notch.b0.fill(1.0F);
+        notch.b2.fill(0.0F);
+        notch.a1.fill(0.0F);
+        notch.a2.fill(0.0F);
+    }
+    _enabledStages = 0;
+    reset();
+}
+
+template <size_t DYNAMIC_NOTCH_COUNT>
+void GyroFilterChain<DYNAMIC_NOTCH_COUNT>::resetStage(size_t stage)
+{
+    if (stage == POWER_TRANSFER) {
+        _stages.powerTransfer.state = {};
+        return;
+    }
+    notch_t& notch = _stages.notches[stage - STATIC_NOTCH_0];
+    notch.x1 = {};
+    notch.x2 = {};
+    notch.y1 = {};
+    notch.y2 = {};
+}
+
+template <size_t DYNAMIC_NOTCH_COUNT>
+void GyroFilterChain<DYNAMIC_NOTCH_COUNT>::reset()
+{
+    for (size_t ii = 0; ii < STAGE_COUNT; ++ii) {
+        resetStage(ii);
+    }
+}
+
+/*!
+Same coefficients as BiquadFilter::setNotchFrequency.
+*/
+template <size_t DYNAMIC_NOTCH_COUNT>
+void GyroFilterChain<DYNAMIC_NOTCH_COUNT>::setNotchFrequency(notch_t& notch, size_t axis, float frequencyHz, float Q)
+{
+    const float omega = frequencyHz*_2PiLoopTimeSeconds;
+    const float cosOmega = cosf(omega);
+    const float alpha = sinf(omega)/(2.0F*Q);
+    const float a0reciprocal = 1.0F/(1.0F + alpha);
+
+    notch.b0[axis] = a0reciprocal;
+    notch.b2[axis] = a0reciprocal;
+    notch.a1[axis] = -2.0F*cosOmega*a0reciprocal;
+    notch.a2[axis] = (1.0F - alpha)*a0reciprocal;
+}
+
+template <size_t DYNAMIC_NOTCH_COUNT>
+inline void GyroFilterChain<DYNAMIC_NOTCH_COUNT>::filter(const float* input, float* output)
+{
+    // the input is set from scalars, rather than stored to memory and loaded as a vector, which would stall store forwarding
+    vector_t x = set(denormalOffset(input[0]), denormalOffset(input[1]), denormalOffset(input[2]));
+
+    if (_enabledStages & (1U << POWER_TRANSFER)) {
+        power_transfer_t& pt = _stages.powerTransfer;
+        const vector_t state = add(load(pt.state), mul(load(pt.k), sub(x, load(pt.state))));
+        store(pt.state, state);
+        x = state;
+    }
+    for (size_t stage = STATIC_NOTCH_0; stage < STAGE_COUNT; ++stage) {
+        if (!(_enabledStages & (1U << stage))) {
+            continue;
+        }
+        notch_t& n = _stages.notches[stage - STATIC_NOTCH_0];
+        const vector_t x1 = load(n.x1);
+        const vector_t y1 = load(n.y1);
+        // b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2, with b1 == a1
+        // b0*x is added last, so the path from this stage's input to its output is only a multiply and an add
+        const vector_t y = snap(add(mul(load(n.b0), x), sub(add(mul(load(n.b2), load(n.x2)), mul(load(n.a1), sub(x1, y1))), mul(load(n.a2), load(n.y2)))));
+        store(n.x2, x1);
+        store(n.x1, x);
+        store(n.y2, y1);
+        store(n.y1, y);
+        x = y;
+    }
+    alignas(16) lanes_t out;
+    store(out, x);
+    output[0] = out[0];
+    output[1] = out[1];
+    output[2] = out[2];
+}
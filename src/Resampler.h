@@ -0,0 +1,77 @@
+#pragma once
+
+#include "RollingBuffer.h"
+#include <cassert>
+#include <cstddef>
+
+
+/*!
+Streaming arbitrary-ratio resampler, using Farrow-structure cubic (Lagrange) interpolation over the last 4 input samples.
+
+The ratio is the number of input samples per output sample, ie inputRate/outputRate, so resampling 1.1kHz to 1kHz
+has a ratio of 1.1. The ratio may be changed at any time, eg to track a drifting clock; the next output is already scheduled, so the new ratio sets the spacing after it.
+
+Each output is interpolated between the middle two of the last 4 inputs, so the output is delayed by between 1 and 2 input samples,
+and costs about a dozen multiply-adds, independent of the ratio.
+The interpolator does not band-limit its input: when downsampling, low-pass filter the input first, eg with a PolyphaseDecimator.
+*/
+class FarrowResampler {
+public:
+    explicit FarrowResampler(float ratio = 1.0F) : _ratio(ratio) { assert(ratio > 0.0F && "ratio must be positive"); }
+public:
+    inline void setRatio(float ratio) { assert(ratio > 0.0F && "ratio must be positive"); _ratio = ratio; }
+    inline float getRatio() const { return _ratio; }
+    //! Returns the maximum number of outputs the block filter can write for inputCount inputs at the current ratio.
+    inline size_t maxOutputCount(size_t inputCount) const { return static_cast<size_t>(static_cast<float>(inputCount)/_ratio) + 1; }
+    inline void reset() { _history = RollingBuffer<float, 4>(); _mu = 0.0F; }
+
+    //! Adds input to the history. Call `nextOutput()` until it returns false to get the outputs that are now available.
+    inline void pushBack(float input) {
+        _history.pushBack(input);
+        if (_history.size() == 4) {
+            _mu -= 1.0F;
+        }
+    }
+    //! If an output is available, sets output to its value and returns true, otherwise returns false.
+    inline bool nextOutput(float& output) {
+        if (_history.size() < 4 || _mu >= 0.0F) {
+            return false;
+        }
+        output = interpolate(_mu + 1.0F);
+        _mu += _ratio;
+        return true;
+    }
+    /*!
+    Resamples a block of inputCount inputs. Returns the number of outputs written.
+    output must have room for at least `maxOutputCount(inputCount)` samples.
+    */
+    inline size_t filter(const float* input, float* output, size_t inputCount) {
+        size_t outputCount = 0;
+        for (size_t ii = 0; ii < inputCount; ++ii) {
+            pushBack(input[ii]);
+            while (nextOutput(output[outputCount])) {
+                ++outputCount;
+            }
+        }
+        return outputCount;
+    }
+    /*!
+    Interpolates the history at mu, where mu = 0 is the second oldest sample, and mu = 1 is the second newest.
+    The Lagrange polynomial is evaluated in Farrow form: the coefficients are computed from the samples, and
+    the polynomial in mu is evaluated by Horner's method.
+    */
+    inline float interpolate(float mu) const {
+        const float ym1 = _history[0];
+        const float y0 = _history[1];
+        const float y1 = _history[2];
+        const float y2 = _history[3];
+        const float c1 = y1 - ym1*(1.0F/3.0F) - y0*0.5F - y2*(1.0F/6.0F);
+        const float c2 = (ym1 + y1)*0.5F - y0;
+        const float c3 = (y2 - ym1)*(1.0F/6.0F) + (y0 - y1)*0.5F;
+        return ((c3*mu + c2)*mu + c1)*mu + y0;
+    }
+private:
+    RollingBuffer<float, 4> _history;
+    float _ratio;
+    float _mu {0.0F}; //!< Position of the next output relative to the second newest sample, in input samples, negative when it is available.
+};
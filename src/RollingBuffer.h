@@ -1,8 +1,11 @@
 #pragma once
 
+#include "BufferCopy.h"
 #include <array>
+#include <cassert>
 #include <cstddef>
-#include <cstring>
+#include <type_traits>
+#include <utility>
 
 
 /*!
@@ -19,6 +22,10 @@ public:
     inline size_t size() const { return _size; }
     inline bool isEmpty() const { return _size == 0; }
     void pushBack(const T& value);
+    void pushBack(T&& value);
+    //! Constructs a temporary T from args and move-assigns it into the slot at the back of the buffer.
+    template <typename... Args>
+    void emplaceBack(Args&&... args);
     inline const T& operator[](size_t index) const {
         size_t pos = _begin + index;
         if (pos > capacity()) {
@@ -30,10 +37,10 @@ public:
     inline const T& back() const { return _end > 0 ? _buffer[_end - 1] : _buffer[CAPACITY]; }
     inline void copy(std::array<T, C>& dest) const {
         if (_end >= _begin) {
-            memcpy(&dest[0], &_buffer[_begin], (_end - _begin) * sizeof(T));
+            copyItems(&dest[0], &_buffer[_begin], _end - _begin);
         } else {
-            memcpy(&dest[0], &_buffer[_begin], (CAPACITY + 1 - _begin) * sizeof(T));
-            memcpy(&dest[CAPACITY + 1 - _begin], &_buffer[0], _end * sizeof(T));
+            copyItems(&dest[0], &_buffer[_begin], CAPACITY + 1 - _begin);
+            copyItems(&dest[CAPACITY + 1 - _begin], &_buffer[0], _end);
         }
     }
     inline size_t getBegin() { return _begin; }
@@ -55,6 +62,9 @@ public:
     };
     const Iterator begin() const { return Iterator(*this, _begin); }
     const Iterator end() const { return Iterator(*this, _end); }
+    friend class SnapshotAccess; // for saveSnapshot() and loadSnapshot(), see Snapshot.h
+private:
+    void advanceEnd();
 private:
     size_t _begin; //!< The virtual beginning of the rolling buffer.
     size_t _end;   //!< The virtual end of the rolling buffer (one behind the last element).
@@ -66,6 +76,27 @@ template <typename T, size_t C>
 void RollingBuffer<T, C>::pushBack(const T& value)
 {
     _buffer[_end] = value; // sizeof(_buffer) = CAPACITY + 1, so always OK to store value at _end
+    advanceEnd();
+}
+
+template <typename T, size_t C>
+void RollingBuffer<T, C>::pushBack(T&& value)
+{
+    _buffer[_end] = std::move(value);
+    advanceEnd();
+}
+
+template <typename T, size_t C>
+template <typename... Args>
+void RollingBuffer<T, C>::emplaceBack(Args&&... args)
+{
+    _buffer[_end] = T(std::forward<Args>(args)...);
+    advanceEnd();
+}
+
+template <typename T, size_t C>
+void RollingBuffer<T, C>::advanceEnd()
+{
     ++_end;
 
     if (_size >= capacity()) {//[[likely]]
@@ -88,6 +119,8 @@ void RollingBuffer<T, C>::pushBack(const T& value)
 Static rolling buffer of type T and capacity C.
 Items are pushed on the back and, once the buffer is full, items just fall off the front.
 Maintains sum of items in buffer.
+For non-integral T, eg float, the running sum is replaced every capacity() pushes by a fresh sum of the items pushed since
+the last replacement, so rounding errors do not accumulate over long runs, without the cost of a `recalculateSum()`.
 */
 template <typename T, size_t C>
 class RollingBufferWithSum {
@@ -109,10 +142,10 @@ public:
     inline const T& back() const { return _end > 0 ? _buffer[_end - 1] : _buffer[CAPACITY]; }
     inline void copy(std::array<T, C>& dest) const {
         if (_end >= _begin) {
-            memcpy(&dest[0], &_buffer[_begin], (_end - _begin) * sizeof(T));
+            copyItems(&dest[0], &_buffer[_begin], _end - _begin);
         } else {
-            memcpy(&dest[0], &_buffer[_begin], (CAPACITY + 1 - _begin) * sizeof(T));
-            memcpy(&dest[CAPACITY + 1 - _begin], &_buffer[0], _end * sizeof(T));
+            copyItems(&dest[0], &_buffer[_begin], CAPACITY + 1 - _begin);
+            copyItems(&dest[CAPACITY + 1 - _begin], &_buffer[0], _end);
         }
     }
     inline size_t capacity() const { return CAPACITY; }
@@ -133,11 +166,14 @@ public:
     };
     const Iterator begin() const { return Iterator(*this, _begin); }
     const Iterator end() const { return Iterator(*this, _end); }
+    friend class SnapshotAccess; // for saveSnapshot() and loadSnapshot(), see Snapshot.h
 private:
     size_t _begin; //!< The virtual beginning of the rolling buffer.
     size_t _end;   //!< The virtual end of the rolling buffer (one behind the last element).
     size_t _size;  //!< The number of items in the rolling buffer.
     T _sum {};
+    T _epochSum {}; //!< Sum of the items pushed since _sum was last replaced.
+    size_t _epochCount {0}; //!< Number of items pushed since _sum was last replaced.
     std::array<T, CAPACITY + 1> _buffer {}; // need one spare empty cell so we can avoid _end == _begin when full
 };
 
@@ -163,6 +199,16 @@ void RollingBufferWithSum<T, C>::pushBack(const T& value)
     } else {
         ++_size;
     }
+    if constexpr (!std::is_integral_v<T>) {
+        _epochSum += value;
+        ++_epochCount;
+        if (_epochCount == capacity()) {
+            // the buffer now holds exactly the items pushed since the last replacement, so their sum replaces the drifted running sum
+            _sum = _epochSum;
+            _epochSum = T {};
+            _epochCount = 0;
+        }
+    }
 }
 
 template <typename T, size_t C>
@@ -174,3 +220,68 @@ T RollingBufferWithSum<T, C>::recalculateSum()
     }
     return _sum;
 }
+
+
+/*!
+Rolling buffer of capacity C that stores prefix sums of the items of type T pushed, rather than the items themselves.
+Gives the sum and mean of the most recent `window` items, for any window up to the capacity, in O(1).
+So, for example, the 10ms, 100ms and 1s averages of a stream can be calculated from a single buffer.
+
+The prefix sums restart every C pushes (an epoch), and a window spans at most two epochs,
+so for floating point T the stored sums, and so the rounding errors, stay bounded however long the buffer runs.
+*/
+template <typename T, size_t C>
+class RollingBufferWithPrefixSum {
+public:
+    RollingBufferWithPrefixSum() = default;
+private:
+    enum { CAPACITY = C };
+public:
+    inline size_t size() const { return _size; }
+    inline bool isEmpty() const { return _size == 0; }
+    inline size_t capacity() const { return CAPACITY; }
+    void pushBack(const T& value);
+    //! Returns the sum of the most recent window items, window must not be greater than size().
+    T sum(size_t window) const;
+    inline T mean(size_t window) const { return window == 0 ? T {} : sum(window) / static_cast<T>(window); }
+    //! Returns the most recent item.
+    inline T back() const { return sum(1); }
+    inline void reset() { _prefixSums[0] = T {}; _end = 0; _size = 0; _epochCount = 0; }
+private:
+    inline const T& prefixSum(size_t offset) const { return _prefixSums[_end >= offset ? _end - offset : _end + CAPACITY + 1 - offset]; }
+private:
+    size_t _end {0}; //!< Index of the prefix sum of the most recent item.
+    size_t _size {0}; //!< The number of items in the rolling buffer.
+    size_t _epochCount {0}; //!< Number of items pushed in the current epoch.
+    std::array<T, CAPACITY + 1> _prefixSums {}; //!< Sums of the items pushed since the start of their epoch, one extra for the sum before the oldest item
+};
+
+template <typename T, size_t C>
+void RollingBufferWithPrefixSum<T, C>::pushBack(const T& value)
+{
+    const T previous = (_epochCount == CAPACITY) ? T {} : _prefixSums[_end];
+    if (_epochCount == CAPACITY) {
+        _epochCount = 0;
+    }
+    ++_epochCount;
+    ++_end;
+    if (_end > CAPACITY) {
+        _end = 0;
+    }
+    _prefixSums[_end] = previous + value;
+    if (_size < CAPACITY) {
+        ++_size;
+    }
+}
+
+template <typename T, size_t C>
+T RollingBufferWithPrefixSum<T, C>::sum(size_t window) const
+{
+    assert(window <= _size);
+    if (window < _epochCount) {
+        // window lies within the current epoch
+        return _prefixSums[_end] - prefixSum(window);
+    }
+    // window spans the end of the previous epoch, so add the previous epoch's total
+    return _prefixSums[_end] + (prefixSum(_epochCount) - prefixSum(window));
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+
+/*!
+Rolling buffer of int32_t samples that is delta-encoded and bit-packed, for long histories of slow-moving signals,
+eg ADC readings.
+
+Samples are grouped into frames of FRAME_SIZE samples. Each frame is stored as its first sample (the base)
+followed by the zigzag-encoded differences between consecutive samples, bit-packed at the width of the largest difference.
+So a signal whose consecutive samples differ by less than ±8 takes 4 bits per sample, rather than 32.
+
+Frame payloads are stored in a pool of BYTES bytes, and an 8-byte checkpoint (base, offset and width) of each frame is kept
+in an index, so `operator[]` finds its frame in O(1). The most recently used frame is cached in decoded form, so
+sequential access through `operator[]` or the iterators decodes each frame only once, and `copy()` decodes frames directly.
+
+The buffer holds at most C samples; once full, whole frames fall off the front, so it holds at least C - FRAME_SIZE + 1 samples.
+If the signal does not compress enough for C samples to fit in the pool, then frames also fall off the front when
+the pool is full, so fewer samples are held: size the pool for the expected compression,
+eg BYTES = C*3/4 holds C samples when the differences fit in 6 bits (allowing for the base and any wasted space).
+*/
+template <size_t C, size_t BYTES, size_t FRAME_SIZE = 32>
+class RollingBufferCompressed {
+public:
+    static_assert(FRAME_SIZE >= 2, "RollingBufferCompressed FRAME_SIZE must be at least 2");
+    static_assert(C % FRAME_SIZE == 0 && C >= 2*FRAME_SIZE, "RollingBufferCompressed capacity must be a multiple of FRAME_SIZE, and at least two frames");
+    static_assert(std::has_single_bit(BYTES), "RollingBufferCompressed BYTES must be a power of two");
+    static_assert(BYTES >= 4*(FRAME_SIZE - 1), "RollingBufferCompressed BYTES must be large enough for an incompressible frame");
+    static_assert(BYTES <= (1U << 25U), "RollingBufferCompressed BYTES must be at most 2^25");
+    static constexpr size_t MAX_FRAMES = C / FRAME_SIZE;
+    static constexpr uint32_t OFFSET_MASK = (1U << 26U) - 1U; //!< Offsets into the pool increase monotonically, modulo 2^26
+    struct frame_t {
+        int32_t base; //!< First sample of the frame
+        uint32_t offset : 26; //!< Offset of the payload in the pool, the physical offset is modulo BYTES
+        uint32_t width : 6; //!< Number of bits per difference
+    };
+public:
+    inline size_t capacity() const { return C; }
+    inline size_t size() const { return _frameCount*FRAME_SIZE + _pendingCount; }
+    inline bool isEmpty() const { return size() == 0; }
+    //! Returns the number of bytes of the pool used by the frame payloads.
+    inline size_t bytesUsed() const { return _frameCount == 0 ? 0 : (_poolEnd - _poolBegin) & OFFSET_MASK; }
+
+    void pushBack(int32_t value);
+    inline int32_t operator[](size_t index) const {
+        const size_t frame = index / FRAME_SIZE;
+        if (frame == _frameCount) {
+            return _pending[index % FRAME_SIZE];
+        }
+        if (_cachedFrame != _firstFrame + frame) {
+            _cachedFrame = _firstFrame + frame;
+            decodeFrame(_cachedFrame, &_cache[0]);
+        }
+        return _cache[index % FRAME_SIZE];
+    }
+    inline int32_t front() const { return (*this)[0]; }
+    inline int32_t back() const { return _pendingCount > 0 ? _pending[_pendingCount - 1] : (*this)[size() - 1]; }
+    //! Decodes the whole buffer into dest, which must hold at least size() samples.
+    void copy(std::span<int32_t> dest) const;
+    void clear();
+
+    class Iterator {
+    public:
+        Iterator(const RollingBufferCompressed& rb, size_t index) : _rb(rb), _index(index) {}
+        inline int32_t operator*() const { return _rb[_index]; }
+        inline Iterator& operator++() { ++_index; return *this; }
+        inline bool operator!=(const Iterator& other) const { return _index != other._index || &_rb != &other._rb; }
+    private:
+        const RollingBufferCompressed& _rb;
+        size_t _index;
+    };
+    const Iterator begin() const { return Iterator(*this, 0); }
+    const Iterator end() const { return Iterator(*this, size()); }
+private:
+    static inline uint32_t zigzag(uint32_t delta) { return (delta << 1U) ^ (0U - (delta >> 31U)); }
+    static inline uint32_t unzigzag(uint32_t value) { return (value >> 1U) ^ (0U - (value & 1U)); }
+    static inline size_t payloadSize(uint32_t width) { return (width*(FRAME_SIZE - 1) + 7) / 8; }
+    inline const frame_t& frame(size_t absoluteFrame) const { return _frames[absoluteFrame % MAX_FRAMES]; }
+    void encodePending();
+    void decodeFrame(size_t absoluteFrame, int32_t* dest) const;
+    void dropFrontFrame();
+private:
+    size_t _firstFrame {0}; //!< Absolute number of the oldest frame.
+    size_t _frameCount {0}; //!< Number of encoded frames.
+    size_t _pendingCount {0}; //!< Number of samples in the frame being filled.
+    uint32_t _poolBegin {0}; //!< Offset of the oldest payload.
+    uint32_t _poolEnd {0}; //!< Offset one past the newest payload.
+    mutable size_t _cachedFrame {SIZE_MAX};
+    mutable std::array<int32_t, FRAME_SIZE> _cache {};
+    std::array<int32_t, FRAME_SIZE> _pending {}; //!< The frame being filled, stored uncompressed.
+    std::array<frame_t, MAX_FRAMES> _frames {};
+    std::array<uint8_t, BYTES> _pool {};
+};
+
+template <size_t C, size_t BYTES, size_t FRAME_SIZE>
+void RollingBufferCompressed<C, BYTES, FRAME_SIZE>::pushBack(int32_t value)
+{
+    if (_pendingCount == 0 && _frameCount == MAX_FRAMES) {
+        // starting a new frame, so drop the oldest frame to stay within capacity
+        dropFrontFrame();
+    }
+    _pending[_pendingCount] = value;
+    ++_pendingCount;
+    if (_pendingCount == FRAME_SIZE) {
+        encodePending();
+    }
+}
+
+template <size_t C, size_t BYTES, size_t FRAME_SIZE>
+void RollingBufferCompressed<C, BYTES, FRAME_SIZE>::dropFrontFrame()
+{
+    ++_firstFrame;
+    --_frameCount;
+    _poolBegin = (_frameCount == 0) ? _poolEnd : frame(_firstFrame).offset;
+}
+
+template <size_t C, size_t BYTES, size_t FRAME_SIZE>
+void RollingBufferCompressed<C, BYTES, FRAME_SIZE>::clear()
+{
+    _firstFrame += _frameCount;
+    _frameCount = 0;
+    _pendingCount = 0;
+    _poolBegin = _poolEnd;
+}
+
+template <size_t C, size_t BYTES, size_t FRAME_SIZE>
+void RollingBufferCompressed<C, BYTES, FRAME_SIZE>::encodePending()
+{
+    uint32_t differences = 0;
+    for (size_t ii = 1; ii < FRAME_SIZE; ++ii) {
+        differences |= zigzag(static_cast<uint32_t>(_pending[ii]) - static_cast<uint32_t>(_pending[ii - 1]));
+    }
+    const auto width = static_cast<uint32_t>(std::bit_width(differences));
+    const auto size = static_cast<uint32_t>(payloadSize(width));
+
+    // allocate the payload contiguously in the pool, dropping frames off the front to make room
+    uint32_t offset = _poolEnd;
+    if (offset % BYTES + size > BYTES) {
+        offset = (offset + static_cast<uint32_t>(BYTES - offset % BYTES)) & OFFSET_MASK; // skip the space at the end of the pool
+    }
+    while (_frameCount > 0 && ((offset + size - _poolBegin) & OFFSET_MASK) > BYTES) {
+        dropFrontFrame();
+    }
+    if (_frameCount == 0) {
+        _poolBegin = offset;
+    }
+
+    // bit-pack the differences, least significant bit first
+    uint8_t* payload = &_pool[offset % BYTES];
+    uint64_t bits = 0;
+    size_t bitCount = 0;
+    for (size_t ii = 1; ii < FRAME_SIZE; ++ii) {
+        bits |= static_cast<uint64_t>(zigzag(static_cast<uint32_t>(_pending[ii]) - static_cast<uint32_t>(_pending[ii - 1]))) << bitCount;
+        bitCount += width;
+        while (bitCount >= 8) {
+            *payload++ = static_cast<uint8_t>(bits);
+            bits >>= 8U;
+            bitCount -= 8;
+        }
+    }
+    if (bitCount > 0) {
+        *payload = static_cast<uint8_t>(bits);
+    }
+
+    frame_t& header = _frames[(_firstFrame + _frameCount) % MAX_FRAMES];
+    header.base = _pending[0];
+    header.offset = offset & OFFSET_MASK;
+    header.width = width & 0x3FU;
+    ++_frameCount;
+    _poolEnd = (offset + size) & OFFSET_MASK;
+    _pendingCount = 0;
+}
+
+template <size_t C, size_t BYTES, size_t FRAME_SIZE>
+void RollingBufferCompressed<C, BYTES, FRAME_SIZE>::decodeFrame(size_t absoluteFrame, int32_t* dest) const
+{
+    const frame_t& header = frame(absoluteFrame);
+    const uint8_t* payload = &_pool[header.offset % BYTES];
+    const uint32_t mask = header.width == 32 ? UINT32_MAX : (1U << header.width) - 1U;
+    auto value = static_cast<uint32_t>(header.base);
+    dest[0] = header.base;
+    uint64_t bits = 0;
+    size_t bitCount = 0;
+    for (size_t ii = 1; ii < FRAME_SIZE; ++ii) {
+        while (bitCount < header.width) {
+            bits |= static_cast<uint64_t>(*payload++) << bitCount;
+            bitCount += 8;
+        }
+        value += unzigzag(static_cast<uint32_t>(bits) & mask);
+        bits >>= header.width;
+        bitCount -= header.width;
+        dest[ii] = static_cast<int32_t>(value);
+    }
+}
+
+template <size_t C, size_t BYTES, size_t FRAME_SIZE>
+void RollingBufferCompressed<C, BYTES, FRAME_SIZE>::copy(std::span<int32_t> dest) const
+{
+    assert(dest.size() >= size());
+    for (size_t ii = 0; ii < _frameCount; ++ii) {
+        decodeFrame(_firstFrame + ii, &dest[ii*FRAME_SIZE]);
+    }
+    for (size_t ii = 0; ii < _pendingCount; ++ii) {
+        dest[_frameCount*FRAME_SIZE + ii] = _pending[ii];
+    }
+}
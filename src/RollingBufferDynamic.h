@@ -0,0 +1,234 @@
+#pragma once
+
+#include "BufferCopy.h"
+#include "BufferStorage.h"
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+
+/*!
+Rolling buffer of type T with capacity set at runtime.
+Storage is provided externally, either as a span or from a polymorphic memory resource, see BufferStorage.
+The storage must have capacity + 1 items, use `storageSize()` to calculate this.
+Apart from the capacity, behaves like RollingBuffer.
+*/
+template <typename T>
+class RollingBufferDynamic {
+public:
+    explicit RollingBufferDynamic(std::span<T> storage) : _buffer(storage) { assert(storage.size() >= 2 && "storage must have capacity + 1 items"); }
+#if defined(LIBRARY_FILTERS_HAS_MEMORY_RESOURCE)
+    RollingBufferDynamic(size_t capacity, std::pmr::memory_resource* resource) : _buffer(storageSize(capacity), resource) {}
+#endif
+    static constexpr size_t storageSize(size_t capacity) { return capacity + 1; }
+public:
+    inline size_t size() const { return _size; }
+    inline bool isEmpty() const { return _size == 0; }
+    void pushBack(const T& value);
+    void pushBack(T&& value);
+    //! Constructs a temporary T from args and move-assigns it into the slot at the back of the buffer.
+    template <typename... Args>
+    void emplaceBack(Args&&... args);
+    inline const T& operator[](size_t index) const {
+        size_t pos = _begin + index;
+        if (pos > capacity()) {
+            pos -= capacity() + 1;
+        }
+        return _buffer[pos];
+    }
+    inline const T& front() const { return _buffer[_begin]; }
+    inline const T& back() const { return _end > 0 ? _buffer[_end - 1] : _buffer[capacity()]; }
+    inline void copy(std::span<T> dest) const {
+        assert(dest.size() >= _size);
+        if (_end >= _begin) {
+            copyItems(&dest[0], &_buffer[_begin], _end - _begin);
+        } else {
+            copyItems(&dest[0], &_buffer[_begin], (capacity() + 1 - _begin));
+            copyItems(&dest[capacity() + 1 - _begin], &_buffer[0], _end);
+        }
+    }
+    inline size_t getBegin() { return _begin; }
+    inline size_t getEnd() { return _end; }
+
+    inline size_t capacity() const { return _buffer.size() - 1; }
+
+    class Iterator {
+    public:
+        Iterator(const RollingBufferDynamic& rb, size_t pos) : _rb(rb), _pos(pos) {}
+        inline const T& operator*() const { return _rb._buffer[_pos]; }
+        inline const T* operator->() const { return &_rb._buffer[_pos]; }
+        inline Iterator& operator++() { ++_pos; if (_pos > _rb._size) _pos = 0; return *this; }
+        inline bool operator!=(const Iterator& other) const { return _pos != other._pos || &_rb != &other._rb; }
+        size_t pos() const { return _pos; }
+    private:
+        const RollingBufferDynamic& _rb;
+        size_t _pos;
+    };
+    const Iterator begin() const { return Iterator(*this, _begin); }
+    const Iterator end() const { return Iterator(*this, _end); }
+    friend class SnapshotAccess; // for saveSnapshot() and loadSnapshot(), see Snapshot.h
+private:
+    void advanceEnd();
+private:
+    size_t _begin {0}; //!< The virtual beginning of the rolling buffer.
+    size_t _end {0};   //!< The virtual end of the rolling buffer (one behind the last element).
+    size_t _size {0};  //!< The number of items in the rolling buffer.
+    BufferStorage<T> _buffer; // has one spare empty cell so we can avoid _end == _begin when full
+};
+
+template <typename T>
+void RollingBufferDynamic<T>::pushBack(const T& value)
+{
+    _buffer[_end] = value; // _buffer.size() = capacity + 1, so always OK to store value at _end
+    advanceEnd();
+}
+
+template <typename T>
+void RollingBufferDynamic<T>::pushBack(T&& value)
+{
+    _buffer[_end] = std::move(value);
+    advanceEnd();
+}
+
+template <typename T>
+template <typename... Args>
+void RollingBufferDynamic<T>::emplaceBack(Args&&... args)
+{
+    _buffer[_end] = T(std::forward<Args>(args)...);
+    advanceEnd();
+}
+
+template <typename T>
+void RollingBufferDynamic<T>::advanceEnd()
+{
+    ++_end;
+
+    if (_size >= capacity()) {//[[likely]]
+        // buffer is full, so don't increment size, instead drop items off front by incrementing _begin
+        ++_begin;
+        // wrap _begin if required
+        if (_begin > capacity()) {
+            _begin = 0;
+        }
+        // wrap _end if required
+        if (_end > capacity()) {
+            _end = 0;
+        }
+    } else {
+        ++_size;
+    }
+}
+
+/*!
+Rolling buffer of type T with capacity set at runtime.
+Maintains sum of items in buffer.
+For non-integral T, eg float, the running sum is replaced every capacity() pushes by a fresh sum of the items pushed since
+the last replacement, so rounding errors do not accumulate over long runs, without the cost of a `recalculateSum()`.
+Storage is provided externally, either as a span or from a polymorphic memory resource, see BufferStorage.
+The storage must have capacity + 1 items, use `storageSize()` to calculate this.
+Apart from the capacity, behaves like RollingBufferWithSum.
+*/
+template <typename T>
+class RollingBufferWithSumDynamic {
+public:
+    explicit RollingBufferWithSumDynamic(std::span<T> storage) : _buffer(storage) { assert(storage.size() >= 2 && "storage must have capacity + 1 items"); }
+#if defined(LIBRARY_FILTERS_HAS_MEMORY_RESOURCE)
+    RollingBufferWithSumDynamic(size_t capacity, std::pmr::memory_resource* resource) : _buffer(storageSize(capacity), resource) {}
+#endif
+    static constexpr size_t storageSize(size_t capacity) { return capacity + 1; }
+public:
+    inline size_t size() const { return _size; }
+    void pushBack(const T& value);
+    inline const T& operator[](size_t index) const {
+        size_t pos = _begin + index;
+        if (pos > capacity()) {
+            pos -= capacity() + 1;
+        }
+        return _buffer[pos];
+    }
+    inline const T& front() const { return _buffer[_begin]; }
+    inline const T& back() const { return _end > 0 ? _buffer[_end - 1] : _buffer[capacity()]; }
+    inline void copy(std::span<T> dest) const {
+        assert(dest.size() >= _size);
+        if (_end >= _begin) {
+            copyItems(&dest[0], &_buffer[_begin], _end - _begin);
+        } else {
+            copyItems(&dest[0], &_buffer[_begin], (capacity() + 1 - _begin));
+            copyItems(&dest[capacity() + 1 - _begin], &_buffer[0], _end);
+        }
+    }
+
+    inline size_t capacity() const { return _buffer.size() - 1; }
+    inline T sum() const { return _sum; }
+    T recalculateSum();
+
+    class Iterator {
+    public:
+        Iterator(const RollingBufferWithSumDynamic& rb, size_t pos) : _rb(rb), _pos(pos) {}
+        inline const T& operator*() const { return _rb._buffer[_pos]; }
+        inline const T* operator->() const { return &_rb._buffer[_pos]; }
+        inline Iterator& operator++() { ++_pos; if (_pos > _rb._size) _pos = 0; return *this; }
+        inline bool operator!=(const Iterator& other) const { return _pos != other._pos || &_rb != &other._rb; }
+        size_t pos() const { return _pos; }
+    private:
+        const RollingBufferWithSumDynamic& _rb;
+        size_t _pos;
+    };
+    const Iterator begin() const { return Iterator(*this, _begin); }
+    const Iterator end() const { return Iterator(*this, _end); }
+    friend class SnapshotAccess; // for saveSnapshot() and loadSnapshot(), see Snapshot.h
+private:
+    size_t _begin {0}; //!< The virtual beginning of the rolling buffer.
+    size_t _end {0};   //!< The virtual end of the rolling buffer (one behind the last element).
+    size_t _size {0};  //!< The number of items in the rolling buffer.
+    T _sum {};
+    T _epochSum {}; //!< Sum of the items pushed since _sum was last replaced.
+    size_t _epochCount {0}; //!< Number of items pushed since _sum was last replaced.
+    BufferStorage<T> _buffer; // has one spare empty cell so we can avoid _end == _begin when full
+};
+
+template <typename T>
+void RollingBufferWithSumDynamic<T>::pushBack(const T& value)
+{
+    _sum += value;
+    _buffer[_end] = value; // _buffer.size() = capacity + 1, so always OK to store value at _end
+    ++_end;
+
+    if (_size >= capacity()) {//[[likely]]
+        // buffer is full, so don't increment size, instead drop items off front by incrementing _begin
+        _sum -= _buffer[_begin];
+        ++_begin;
+        // wrap _begin if required
+        if (_begin > capacity()) {
+            _begin = 0;
+        }
+        // wrap _end if required
+        if (_end > capacity()) {
+            _end = 0;
+        }
+    } else {
+        ++_size;
+    }
+    if constexpr (!std::is_integral_v<T>) {
+        _epochSum += value;
+        ++_epochCount;
+        if (_epochCount == capacity()) {
+            // the buffer now holds exactly the items pushed since the last replacement, so their sum replaces the drifted running sum
+            _sum = _epochSum;
+            _epochSum = T {};
+            _epochCount = 0;
+        }
+    }
+}
+
+template <typename T>
+T RollingBufferWithSumDynamic<T>::recalculateSum()
+{
+    _sum = 0;
+    for (auto it = begin(); it != end(); ++it) {
+        _sum += *it;
+    }
+    return _sum;
+}
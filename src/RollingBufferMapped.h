@@ -0,0 +1,211 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+
+
+/*!
+Rolling buffer of type T and capacity C whose items and indices are stored in a memory-mapped file, Linux only.
+
+The buffer survives a crash of the process: a restarted process that opens the same file reattaches to the history
+in place, without any copy or reload. (Surviving a power loss additionally requires calling `sync()`.)
+
+The file holds a header followed by C + 1 slots. The header records the total number of items ever pushed (the count),
+from which the beginning and end of the buffer are derived, so publishing an item is a single 64-bit store.
+A new item is written into the spare slot, which is not visible, before the count is published.
+
+Writes are bracketed by a sequence number, which is odd while a write is in progress (a seqlock).
+If, on attaching, the sequence number shows a write was in progress, then the last write was torn:
+it was never published, so it is discarded, and `getAttachStatus()` returns `ATTACHED_TORN_WRITE_DISCARDED`.
+
+If the file cannot be opened, sized, or mapped, then `isMapped()` returns false and the buffer stays empty:
+`pushBack()` returns false, and `count()` returns zero. As with the other rolling buffers, `front()`, `back()` and `operator[]`
+must only be called on a buffer that is not empty.
+*/
+template <typename T, size_t C>
+class RollingBufferMapped {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "RollingBufferMapped items must be trivially copyable");
+    static_assert(C > 0, "RollingBufferMapped capacity must be greater than zero");
+    static constexpr uint32_t MAGIC = 0x4D425246; // "FRBM"
+    static constexpr uint32_t VERSION = 1;
+    enum attach_status_e { NOT_MAPPED, CREATED, ATTACHED, ATTACHED_TORN_WRITE_DISCARDED };
+    struct alignas(64) header_t {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t itemSize;
+        uint32_t capacity;
+        std::atomic<uint64_t> sequence; //!< odd while a write is in progress
+        std::atomic<uint64_t> count; //!< total number of items ever pushed
+        std::atomic<uint64_t> clearedCount; //!< value of count when the buffer was last cleared
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "RollingBufferMapped requires lock-free 64-bit atomics");
+    static constexpr size_t ITEMS_OFFSET = (sizeof(header_t) + alignof(T) - 1) / alignof(T) * alignof(T);
+    static constexpr size_t FILE_SIZE = ITEMS_OFFSET + (C + 1) * sizeof(T);
+public:
+    explicit RollingBufferMapped(const char* path);
+    ~RollingBufferMapped();
+    RollingBufferMapped(const RollingBufferMapped&) = delete;
+    RollingBufferMapped& operator=(const RollingBufferMapped&) = delete;
+    RollingBufferMapped(RollingBufferMapped&&) = delete;
+    RollingBufferMapped& operator=(RollingBufferMapped&&) = delete;
+public:
+    inline bool isMapped() const { return _header != nullptr; }
+    inline attach_status_e getAttachStatus() const { return _attachStatus; }
+    inline size_t capacity() const { return C; }
+    inline size_t size() const { return _size; }
+    inline bool isEmpty() const { return _size == 0; }
+    //! Returns the total number of items pushed over the lifetime of the file.
+    inline uint64_t count() const { return isMapped() ? _header->count.load(std::memory_order_relaxed) : 0; }
+    //! Returns false, and does nothing, if the buffer is not mapped.
+    bool pushBack(const T& value);
+    inline const T& operator[](size_t index) const {
+        assert(index < _size && "RollingBufferMapped index out of range");
+        size_t pos = _begin + index;
+        if (pos > C) {
+            pos -= C + 1;
+        }
+        return _items[pos];
+    }
+    inline const T& front() const { assert(!isEmpty() && "RollingBufferMapped is empty"); return _items[_begin]; }
+    inline const T& back() const { assert(!isEmpty() && "RollingBufferMapped is empty"); return _end > 0 ? _items[_end - 1] : _items[C]; }
+    void clear();
+    //! Writes the mapped file to storage, so the buffer also survives a power loss.
+    inline bool sync() { return isMapped() && msync(_header, FILE_SIZE, MS_SYNC) == 0; }
+private:
+    void initialize();
+    void attach();
+private:
+    header_t* _header {nullptr};
+    T* _items {nullptr};
+    size_t _begin {0}; //!< The beginning of the rolling buffer, derived from the header count.
+    size_t _end {0};   //!< The end of the rolling buffer (one behind the last element).
+    size_t _size {0};
+    attach_status_e _attachStatus {NOT_MAPPED};
+};
+
+template <typename T, size_t C>
+RollingBufferMapped<T, C>::RollingBufferMapped(const char* path)
+{
+    const int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644); // NOLINT(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+    if (fd < 0) {
+        return;
+    }
+    struct stat fileStat {};
+    const bool sizeOK = fstat(fd, &fileStat) == 0 && static_cast<size_t>(fileStat.st_size) == FILE_SIZE;
+    if (!sizeOK && ftruncate(fd, static_cast<off_t>(FILE_SIZE)) != 0) {
+        close(fd);
+        return;
+    }
+    void* mapped = mmap(nullptr, FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // the mapping remains valid after the file is closed
+    if (mapped == MAP_FAILED) { // NOLINT(cppcoreguidelines-pro-type-cstyle-cast,performance-no-int-to-ptr)
+        return;
+    }
+    _header = static_cast<header_t*>(mapped);
+    _items = reinterpret_cast<T*>(static_cast<uint8_t*>(mapped) + ITEMS_OFFSET); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+
+    if (sizeOK && _header->magic == MAGIC && _header->version == VERSION && _header->itemSize == sizeof(T) && _header->capacity == C) {
+        attach();
+    } else {
+        initialize();
+    }
+}
+
+template <typename T, size_t C>
+RollingBufferMapped<T, C>::~RollingBufferMapped()
+{
+    if (_header) {
+        munmap(_header, FILE_SIZE);
+    }
+}
+
+template <typename T, size_t C>
+void RollingBufferMapped<T, C>::initialize()
+{
+    _header->magic = MAGIC;
+    _header->version = VERSION;
+    _header->itemSize = sizeof(T);
+    _header->capacity = C;
+    _header->count.store(0, std::memory_order_relaxed);
+    _header->clearedCount.store(0, std::memory_order_relaxed);
+    _header->sequence.store(0, std::memory_order_release);
+    _begin = 0;
+    _end = 0;
+    _size = 0;
+    _attachStatus = CREATED;
+}
+
+template <typename T, size_t C>
+void RollingBufferMapped<T, C>::attach()
+{
+    const uint64_t count = _header->count.load(std::memory_order_acquire);
+    const uint64_t sequence = _header->sequence.load(std::memory_order_acquire);
+    const uint64_t clearedCount = _header->clearedCount.load(std::memory_order_relaxed);
+    if (clearedCount > count || (sequence != 2*count && sequence != 2*count + 1 && sequence + 1 != 2*count)) {
+        // the header is inconsistent, so the file is not a valid buffer
+        initialize();
+        return;
+    }
+    // if sequence + 1 == 2*count the process crashed after the item was published but before the sequence number was updated, so the item is kept
+    // if sequence == 2*count + 1 the process crashed while writing an item, before the count was published, so the item is discarded
+    _attachStatus = (sequence == 2*count + 1) ? ATTACHED_TORN_WRITE_DISCARDED : ATTACHED;
+    _header->sequence.store(2*count, std::memory_order_release);
+
+    const uint64_t available = count - clearedCount;
+    _size = available < C ? static_cast<size_t>(available) : C;
+    _end = static_cast<size_t>(count % (C + 1));
+    _begin = _end >= _size ? _end - _size : _end + C + 1 - _size;
+}
+
+template <typename T, size_t C>
+bool RollingBufferMapped<T, C>::pushBack(const T& value)
+{
+    if (!isMapped()) {
+        return false;
+    }
+    const uint64_t count = _header->count.load(std::memory_order_relaxed);
+    _header->sequence.store(2*count + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    _items[_end] = value; // C + 1 slots, so the slot at _end is never visible
+    _header->count.store(count + 1, std::memory_order_release);
+    _header->sequence.store(2*count + 2, std::memory_order_release);
+
+    ++_end;
+    if (_size >= C) {//[[likely]]
+        // buffer full, so begin moves forward with end
+        ++_begin;
+        if (_begin > C) {
+            _begin = 0;
+        }
+    } else {
+        ++_size;
+    }
+    if (_end > C) {
+        _end = 0;
+    }
+    return true;
+}
+
+template <typename T, size_t C>
+void RollingBufferMapped<T, C>::clear()
+{
+    if (!isMapped()) {
+        return;
+    }
+    _header->clearedCount.store(_header->count.load(std::memory_order_relaxed), std::memory_order_release);
+    _begin = _end;
+    _size = 0;
+}
+
+#endif // __linux__
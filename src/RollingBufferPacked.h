@@ -0,0 +1,293 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+/*!
+Storage policies for RollingBufferPacked, which store float samples in 16 bits.
+
+Each policy defines the storage type and functions to pack a float to, and unpack a float from, the storage type.
+`unpackSamples()` and `packSamples()` convert blocks of samples as plain loops over branch-free conversions, so the compiler vectorizes them.
+*/
+
+/*!
+IEEE 754 half precision: 11 significant bits, range ±65504. Relative error at most 2^-11 for normal values.
+Rounds to nearest even; values too large for half precision become infinity.
+*/
+struct Float16Storage {
+    using storage_t = uint16_t;
+    static inline storage_t pack(float value) {
+        constexpr uint32_t F32_INFINITY = 255U << 23U;
+        constexpr uint32_t F16_MAX = (127U + 16U) << 23U; // smallest float that overflows half
+        constexpr uint32_t F16_MIN_NORMAL = 113U << 23U;
+        const float denormalMagic = std::bit_cast<float>(((127U - 15U) + (23U - 10U) + 1U) << 23U);
+        uint32_t bits = std::bit_cast<uint32_t>(value);
+        const uint32_t sign = bits & 0x80000000U;
+        bits ^= sign;
+        uint32_t half {};
+        if (bits >= F16_MAX) {
+            half = (bits > F32_INFINITY) ? 0x7E00U : 0x7C00U; // NaN or infinity
+        } else if (bits < F16_MIN_NORMAL) {
+            // subnormal or zero: use the float adder to shift and round the mantissa
+            half = std::bit_cast<uint32_t>(std::bit_cast<float>(bits) + denormalMagic) - std::bit_cast<uint32_t>(denormalMagic);
+        } else {
+            const uint32_t mantissaOdd = (bits >> 13U) & 1U;
+            bits += (static_cast<uint32_t>(15 - 127) << 23U) + 0xFFFU + mantissaOdd; // rebias exponent and round to nearest even
+            half = bits >> 13U;
+        }
+        return static_cast<storage_t>(half | (sign >> 16U));
+    }
+    static inline float unpack(storage_t half) {
+        const uint32_t sign = static_cast<uint32_t>(half & 0x8000U) << 16U;
+        const uint32_t exponentMantissa = static_cast<uint32_t>(half & 0x7FFFU) << 13U;
+        // rescale by 2^112 to rebias the exponent, this also normalizes subnormals
+        const float magnitude = std::bit_cast<float>(exponentMantissa) * std::bit_cast<float>((127U + 112U) << 23U);
+        const uint32_t infinityOrNaN = exponentMantissa | 0x7F800000U;
+        const uint32_t bits = (exponentMantissa >= (0x7C00U << 13U)) ? infinityOrNaN : std::bit_cast<uint32_t>(magnitude);
+        return std::bit_cast<float>(bits | sign);
+    }
+};
+
+/*!
+bfloat16: the top 16 bits of a float, so 8 significant bits with the full float range. Relative error at most 2^-8.
+Rounds to nearest even.
+*/
+struct BFloat16Storage {
+    using storage_t = uint16_t;
+    static inline storage_t pack(float value) {
+        const uint32_t bits = std::bit_cast<uint32_t>(value);
+        if ((bits & 0x7FFFFFFFU) > 0x7F800000U) {
+            return static_cast<storage_t>((bits >> 16U) | 0x40U); // quiet NaN
+        }
+        return static_cast<storage_t>((bits + 0x7FFFU + ((bits >> 16U) & 1U)) >> 16U);
+    }
+    static inline float unpack(storage_t value) {
+        return std::bit_cast<float>(static_cast<uint32_t>(value) << 16U);
+    }
+};
+
+/*!
+Signed 16-bit fixed point, with ±FULL_SCALE mapping to ±32767, eg Int16ScaledStorage<2000> for a ±2000 degrees/second gyro.
+Absolute error at most FULL_SCALE/65534, values outside ±FULL_SCALE are clamped and NaN is stored as zero.
+*/
+template <int32_t FULL_SCALE>
+struct Int16ScaledStorage {
+    static_assert(FULL_SCALE > 0, "Int16ScaledStorage FULL_SCALE must be greater than zero");
+    using storage_t = int16_t;
+    static constexpr float PACK_SCALE = 32767.0F / static_cast<float>(FULL_SCALE);
+    static constexpr float UNPACK_SCALE = static_cast<float>(FULL_SCALE) / 32767.0F;
+    static inline storage_t pack(float value) {
+        float scaled = std::isnan(value) ? 0.0F : value * PACK_SCALE;
+        scaled = scaled > 32767.0F ? 32767.0F : scaled < -32767.0F ? -32767.0F : scaled;
+        return static_cast<storage_t>(scaled >= 0.0F ? scaled + 0.5F : scaled - 0.5F);
+    }
+    static inline float unpack(storage_t value) { return static_cast<float>(value) * UNPACK_SCALE; }
+};
+
+//! Unpacks count samples, written as a plain loop so it is vectorized.
+template <typename STORAGE>
+inline void unpackSamples(float* dest, const typename STORAGE::storage_t* source, size_t count)
+{
+    for (size_t ii = 0; ii < count; ++ii) {
+        dest[ii] = STORAGE::unpack(source[ii]);
+    }
+}
+
+//! Packs count samples.
+template <typename STORAGE>
+inline void packSamples(typename STORAGE::storage_t* dest, const float* source, size_t count)
+{
+    for (size_t ii = 0; ii < count; ++ii) {
+        dest[ii] = STORAGE::pack(source[ii]);
+    }
+}
+
+
+/*!
+Static rolling buffer of capacity C that stores float samples in 16 bits, using the STORAGE policy,
+eg Float16Storage, BFloat16Storage, or Int16ScaledStorage<FULL_SCALE>.
+Halves the memory used compared to RollingBuffer<float, C>, with bounded error.
+Samples are packed on `pushBack` and unpacked to float by `operator[]`, the iterators, and `copy()`.
+Apart from storage, behaves like RollingBuffer.
+*/
+template <typename STORAGE, size_t C>
+class RollingBufferPacked {
+public:
+    using storage_t = typename STORAGE::storage_t;
+private:
+    enum { CAPACITY = C };
+public:
+    inline size_t size() const { return _size; }
+    inline bool isEmpty() const { return _size == 0; }
+    inline size_t capacity() const { return CAPACITY; }
+    void pushBack(float value);
+    inline float operator[](size_t index) const {
+        size_t pos = _begin + index;
+        if (pos > capacity()) {
+            pos -= capacity() + 1;
+        }
+        return STORAGE::unpack(_buffer[pos]);
+    }
+    inline float front() const { return STORAGE::unpack(_buffer[_begin]); }
+    inline float back() const { return STORAGE::unpack(_end > 0 ? _buffer[_end - 1] : _buffer[CAPACITY]); }
+    inline void copy(std::array<float, C>& dest) const {
+        if (_end >= _begin) {
+            unpackSamples<STORAGE>(&dest[0], &_buffer[_begin], _end - _begin);
+        } else {
+            unpackSamples<STORAGE>(&dest[0], &_buffer[_begin], CAPACITY + 1 - _begin);
+            unpackSamples<STORAGE>(&dest[CAPACITY + 1 - _begin], &_buffer[0], _end);
+        }
+    }
+
+    class Iterator {
+    public:
+        Iterator(const RollingBufferPacked& rb, size_t pos) : _rb(rb), _pos(pos) {}
+        inline float operator*() const { return STORAGE::unpack(_rb._buffer[_pos]); }
+        inline Iterator& operator++() { ++_pos; if (_pos > CAPACITY) _pos = 0; return *this; }
+        inline bool operator!=(const Iterator& other) const { return _pos != other._pos || &_rb != &other._rb; }
+        size_t pos() const { return _pos; }
+    private:
+        const RollingBufferPacked& _rb;
+        size_t _pos;
+    };
+    const Iterator begin() const { return Iterator(*this, _begin); }
+    const Iterator end() const { return Iterator(*this, _end); }
+private:
+    size_t _begin {0}; //!< The virtual beginning of the rolling buffer.
+    size_t _end {0};   //!< The virtual end of the rolling buffer (one behind the last element).
+    size_t _size {0};  //!< The number of items in the rolling buffer.
+    std::array<storage_t, CAPACITY + 1> _buffer {}; // need one spare empty cell so we can avoid _end == _begin when full
+};
+
+template <typename STORAGE, size_t C>
+void RollingBufferPacked<STORAGE, C>::pushBack(float value)
+{
+    _buffer[_end] = STORAGE::pack(value); // sizeof(_buffer) = CAPACITY + 1, so always OK to store value at _end
+    ++_end;
+
+    if (_size >= capacity()) {//[[likely]]
+        // buffer is full, so don't increment size, instead drop items off front by incrementing _begin
+        ++_begin;
+        // wrap _begin if required
+        if (_begin > capacity()) {
+            _begin = 0;
+        }
+        // wrap _end if required
+        if (_end > capacity()) {
+            _end = 0;
+        }
+    } else {
+        ++_size;
+    }
+}
+
+
+/*!
+Static rolling buffer of capacity C that stores float samples in 16 bits, using the STORAGE policy, and maintains their sum.
+The sum is of the unpacked samples, so it is consistent with the stored items, and is held in type SUM, eg double for long windows.
+For non-integral SUM the running sum is replaced every C pushes, so rounding errors do not accumulate, see RollingBufferWithSum.
+Apart from storage, behaves like RollingBufferWithSum.
+*/
+template <typename STORAGE, size_t C, typename SUM = float>
+class RollingBufferPackedWithSum {
+public:
+    using storage_t = typename STORAGE::storage_t;
+private:
+    enum { CAPACITY = C };
+public:
+    inline size_t size() const { return _size; }
+    inline bool isEmpty() const { return _size == 0; }
+    inline size_t capacity() const { return CAPACITY; }
+    void pushBack(float value);
+    inline float operator[](size_t index) const {
+        size_t pos = _begin + index;
+        if (pos > capacity()) {
+            pos -= capacity() + 1;
+        }
+        return STORAGE::unpack(_buffer[pos]);
+    }
+    inline float front() const { return STORAGE::unpack(_buffer[_begin]); }
+    inline float back() const { return STORAGE::unpack(_end > 0 ? _buffer[_end - 1] : _buffer[CAPACITY]); }
+    inline void copy(std::array<float, C>& dest) const {
+        if (_end >= _begin) {
+            unpackSamples<STORAGE>(&dest[0], &_buffer[_begin], _end - _begin);
+        } else {
+            unpackSamples<STORAGE>(&dest[0], &_buffer[_begin], CAPACITY + 1 - _begin);
+            unpackSamples<STORAGE>(&dest[CAPACITY + 1 - _begin], &_buffer[0], _end);
+        }
+    }
+    inline SUM sum() const { return _sum; }
+    SUM recalculateSum();
+
+    class Iterator {
+    public:
+        Iterator(const RollingBufferPackedWithSum& rb, size_t pos) : _rb(rb), _pos(pos) {}
+        inline float operator*() const { return STORAGE::unpack(_rb._buffer[_pos]); }
+        inline Iterator& operator++() { ++_pos; if (_pos > CAPACITY) _pos = 0; return *this; }
+        inline bool operator!=(const Iterator& other) const { return _pos != other._pos || &_rb != &other._rb; }
+        size_t pos() const { return _pos; }
+    private:
+        const RollingBufferPackedWithSum& _rb;
+        size_t _pos;
+    };
+    const Iterator begin() const { return Iterator(*this, _begin); }
+    const Iterator end() const { return Iterator(*this, _end); }
+private:
+    size_t _begin {0}; //!< The virtual beginning of the rolling buffer.
+    size_t _end {0};   //!< The virtual end of the rolling buffer (one behind the last element).
+    size_t _size {0};  //!< The number of items in the rolling buffer.
+    SUM _sum {};
+    SUM _epochSum {}; //!< Sum of the items pushed since _sum was last replaced.
+    size_t _epochCount {0}; //!< Number of items pushed since _sum was last replaced.
+    std::array<storage_t, CAPACITY + 1> _buffer {}; // need one spare empty cell so we can avoid _end == _begin when full
+};
+
+template <typename STORAGE, size_t C, typename SUM>
+void RollingBufferPackedWithSum<STORAGE, C, SUM>::pushBack(float value)
+{
+    const storage_t packed = STORAGE::pack(value);
+    const SUM unpacked = static_cast<SUM>(STORAGE::unpack(packed));
+    _sum += unpacked;
+    _buffer[_end] = packed; // sizeof(_buffer) = CAPACITY + 1, so always OK to store value at _end
+    ++_end;
+
+    if (_size >= capacity()) {//[[likely]]
+        // buffer is full, so don't increment size, instead drop items off front by incrementing _begin
+        _sum -= static_cast<SUM>(STORAGE::unpack(_buffer[_begin]));
+        ++_begin;
+        // wrap _begin if required
+        if (_begin > capacity()) {
+            _begin = 0;
+        }
+        // wrap _end if required
+        if (_end > capacity()) {
+            _end = 0;
+        }
+    } else {
+        ++_size;
+    }
+    if constexpr (!std::is_integral_v<SUM>) {
+        _epochSum += unpacked;
+        ++_epochCount;
+        if (_epochCount == capacity()) {
+            _sum = _epochSum;
+            _epochSum = SUM {};
+            _epochCount = 0;
+        }
+    }
+}
+
+template <typename STORAGE, size_t C, typename SUM>
+SUM RollingBufferPackedWithSum<STORAGE, C, SUM>::recalculateSum()
+{
+    _sum = 0;
+    for (auto it = begin(); it != end(); ++it) {
+        _sum += static_cast<SUM>(*it);
+    }
+    return _sum;
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+
+/*!
+Multi-resolution rolling history of samples of type T, like a round-robin database.
+
+Level 0 holds the most recent C samples. Each level above holds the most recent C aggregates (min, max, sum and count)
+of K items of the level below, so level L covers C*K^L samples at a resolution of K^L samples.
+The levels are updated incrementally by `pushBack()`, in amortized O(1).
+
+`aggregate()` gives the min, max, sum, and mean of a span of samples in O(K*LEVELS), rather than O(span).
+Each end of the span is resolved at the finest level that still holds it, so an end of the span that is older than
+the C samples in level 0 is rounded outwards to the resolution of the level that holds it.
+Spans that reach back beyond the history held by the top level are truncated.
+
+Samples are numbered from 0, in the order pushed, and the next sample pushed has number `count()`.
+*/
+template <typename T, size_t C, size_t K = 10, size_t LEVELS = 4, typename SUM = T>
+class RollingBufferPyramid {
+public:
+    static_assert(K >= 2, "RollingBufferPyramid K must be at least 2");
+    static_assert(C >= K, "RollingBufferPyramid capacity must be at least K");
+    static_assert(LEVELS >= 1, "RollingBufferPyramid must have at least one level");
+    struct aggregate_t {
+        T min;
+        T max;
+        SUM sum;
+        size_t count;
+        inline SUM mean() const { return count == 0 ? SUM {} : sum / static_cast<SUM>(count); }
+    };
+public:
+    inline size_t capacity() const { return C; }
+    inline size_t levels() const { return LEVELS; }
+    //! Returns the total number of samples pushed.
+    inline size_t count() const { return _count; }
+    //! Returns the number of samples at the finest resolution, ie the number of samples in level 0.
+    inline size_t size() const { return _count < C ? _count : C; }
+    inline bool isEmpty() const { return _count == 0; }
+    //! Returns the number of samples aggregated into each item of the given level, ie K^level.
+    static constexpr size_t resolution(size_t level) { return level == 0 ? 1 : K * resolution(level - 1); }
+    //! Returns the index-th sample of level 0, index 0 is the oldest.
+    inline const T& operator[](size_t index) const { return _samples[(_count - size() + index) % C]; }
+    inline const T& back() const { return _samples[(_count - 1) % C]; }
+
+    void pushBack(const T& value);
+    inline void reset() { _count = 0; _partials = {}; }
+
+    //! Returns the aggregate of samples numbered begin (inclusive) to end (exclusive).
+    aggregate_t aggregate(size_t begin, size_t end) const;
+    //! Returns the aggregate of the most recent sampleCount samples.
+    inline aggregate_t aggregateRecent(size_t sampleCount) const { return aggregate(sampleCount < _count ? _count - sampleCount : 0, _count); }
+private:
+    static inline void merge(aggregate_t& aggregate, const aggregate_t& other);
+    inline aggregate_t item(size_t level, size_t index) const {
+        if (level == 0) {
+            const T& sample = _samples[index % C];
+            return aggregate_t { sample, sample, static_cast<SUM>(sample), 1 };
+        }
+        return _levels[level - 1][index % C];
+    }
+    //! Returns the number of complete items in the level.
+    inline size_t levelCount(size_t level) const { return _count / resolution(level); }
+private:
+    size_t _count {0};
+    std::array<T, C> _samples {};
+    std::array<std::array<aggregate_t, C>, LEVELS - 1> _levels {};
+    std::array<aggregate_t, LEVELS - 1> _partials {}; //!< The aggregates currently being accumulated, one per level above 0.
+};
+
+template <typename T, size_t C, size_t K, size_t LEVELS, typename SUM>
+inline void RollingBufferPyramid<T, C, K, LEVELS, SUM>::merge(aggregate_t& aggregate, const aggregate_t& other)
+{
+    if (other.count == 0) {
+        return;
+    }
+    if (aggregate.count == 0) {
+        aggregate = other;
+        return;
+    }
+    if (other.min < aggregate.min) {
+        aggregate.min = other.min;
+    }
+    if (aggregate.max < other.max) {
+        aggregate.max = other.max;
+    }
+    aggregate.sum += other.sum;
+    aggregate.count += other.count;
+}
+
+template <typename T, size_t C, size_t K, size_t LEVELS, typename SUM>
+void RollingBufferPyramid<T, C, K, LEVELS, SUM>::pushBack(const T& value)
+{
+    _samples[_count % C] = value;
+    ++_count;
+
+    // carry completed aggregates up the levels
+    aggregate_t carry { value, value, static_cast<SUM>(value), 1 };
+    for (size_t level = 1; level < LEVELS; ++level) {
+        aggregate_t& partial = _partials[level - 1];
+        merge(partial, carry);
+        if (_count % resolution(level) != 0) {
+            break;
+        }
+        _levels[level - 1][(levelCount(level) - 1) % C] = partial;
+        carry = partial;
+        partial = aggregate_t {};
+    }
+}
+
+template <typename T, size_t C, size_t K, size_t LEVELS, typename SUM>
+typename RollingBufferPyramid<T, C, K, LEVELS, SUM>::aggregate_t RollingBufferPyramid<T, C, K, LEVELS, SUM>::aggregate(size_t begin, size_t end) const
+{
+    aggregate_t ret {};
+    if (end > _count) {
+        end = _count;
+    }
+    // begin and end are in units of items of the current level
+    for (size_t level = 0; level < LEVELS && begin < end; ++level) {
+        const size_t available = levelCount(level);
+        const size_t oldest = available > C ? available - C : 0;
+        if (level == LEVELS - 1) {
+            // top level, so truncate to the history held
+            for (size_t ii = begin < oldest ? oldest : begin; ii < end; ++ii) {
+                merge(ret, item(level, ii));
+            }
+            break;
+        }
+        // take the items at each end of the span that do not make up a whole item of the level above
+        const size_t beginAbove = (begin + K - 1) / K;
+        const size_t endAbove = end / K;
+        if (beginAbove >= endAbove) {
+            // no whole items of the level above, so the span is resolved at this level
+            if (begin >= oldest) {
+                for (size_t ii = begin; ii < end; ++ii) {
+                    merge(ret, item(level, ii));
+                }
+                break;
+            }
+        }
+        if (begin >= oldest) {
+            for (size_t ii = begin; ii < beginAbove*K; ++ii) {
+                merge(ret, item(level, ii));
+            }
+            begin = beginAbove;
+        } else {
+            begin = begin / K; // not held at this level, so round down to the resolution of the level above
+        }
+        if (end - end % K >= oldest) {
+            for (size_t ii = endAbove*K; ii < end; ++ii) {
+                merge(ret, item(level, ii));
+            }
+            end = endAbove;
+        } else {
+            end = (end + K - 1) / K;
+        }
+    }
+    return ret;
+}
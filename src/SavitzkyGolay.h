@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+
+/*!
+Calculates the Savitzky-Golay coefficients for a window of WINDOW samples and a polynomial of order ORDER, evaluated at
+sample EVALUATION_POINT of the window, where 0 is the oldest sample and WINDOW - 1 the newest.
+
+The polynomial is the least squares fit to the window, so its coefficients are linear in the samples:
+solving the normal equations (J^T J) a = J^T y once gives the weights for each polynomial coefficient.
+Samples are at x = -EVALUATION_POINT ... WINDOW - 1 - EVALUATION_POINT, so the value, first derivative and second derivative
+at the evaluation point are a0, a1 and 2*a2.
+
+Returns coefficients[t][output], where t is the number of samples ago, and output is 0 for the value, 1 for the first derivative,
+2 for the second derivative (both per sample period), and 3 is padding, so each tap is a 4-lane vector.
+The calculation is in double and constexpr, so it is done at compile time.
+*/
+template <size_t WINDOW, size_t ORDER, size_t EVALUATION_POINT>
+constexpr std::array<std::array<float, 4>, WINDOW> savitzkyGolayCoefficients()
+{
+    constexpr size_t N = ORDER + 1;
+    auto power = [](double x, size_t n) { double ret = 1.0; for (size_t ii = 0; ii < n; ++ii) { ret *= x; } return ret; };
+    auto absolute = [](double x) { return x < 0.0 ? -x : x; };
+    auto position = [](size_t t) { return static_cast<double>(WINDOW - 1 - t) - static_cast<double>(EVALUATION_POINT); };
+
+    // normal matrix J^T J, where J[t][j] = x_t^j
+    std::array<std::array<double, N>, N> normal {};
+    std::array<std::array<double, N>, N> inverse {};
+    for (size_t jj = 0; jj < N; ++jj) {
+        for (size_t kk = 0; kk < N; ++kk) {
+            for (size_t t = 0; t < WINDOW; ++t) {
+                normal[jj][kk] += power(position(t), jj + kk);
+            }
+        }
+        inverse[jj][jj] = 1.0;
+    }
+    // invert by Gauss-Jordan elimination with partial pivoting
+    for (size_t col = 0; col < N; ++col) {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < N; ++row) {
+            if (absolute(normal[row][col]) > absolute(normal[pivot][col])) {
+                pivot = row;
+            }
+        }
+        std::swap(normal[col], normal[pivot]);
+        std::swap(inverse[col], inverse[pivot]);
+        const double scale = 1.0 / normal[col][col];
+        for (size_t kk = 0; kk < N; ++kk) {
+            normal[col][kk] *= scale;
+            inverse[col][kk] *= scale;
+        }
+        for (size_t row = 0; row < N; ++row) {
+            if (row != col) {
+                const double factor = normal[row][col];
+                for (size_t kk = 0; kk < N; ++kk) {
+                    normal[row][kk] -= factor*normal[col][kk];
+                    inverse[row][kk] -= factor*inverse[col][kk];
+                }
+            }
+        }
+    }
+    // the weight of sample t in a_k is row k of (J^T J)^-1 J^T
+    std::array<std::array<float, 4>, WINDOW> coefficients {};
+    for (size_t t = 0; t < WINDOW; ++t) {
+        for (size_t kk = 0; kk < 3 && kk < N; ++kk) {
+            double weight = 0.0;
+            for (size_t jj = 0; jj < N; ++jj) {
+                weight += inverse[kk][jj]*power(position(t), jj);
+            }
+            coefficients[t][kk] = static_cast<float>(kk == 2 ? 2.0*weight : weight);
+        }
+    }
+    return coefficients;
+}
+
+/*!
+Savitzky-Golay filter: fits a polynomial of order ORDER to the last WINDOW samples, by least squares,
+and returns its value, first derivative, and second derivative, eg to smooth and differentiate noisy position data.
+
+The coefficients are calculated at compile time.
+The value and both derivatives are calculated from the same history, in a single pass: the coefficients of each tap
+are stored as a 4-lane vector, so each tap is one vector multiply-add.
+
+By default the polynomial is evaluated at the center of the window, so the filter has linear phase
+(no phase distortion), and a delay of (WINDOW - 1)/2 samples. Setting EVALUATION_POINT to WINDOW - 1 evaluates the polynomial at
+the newest sample, which has no delay, but less noise reduction.
+ORDER must be at least 2 for the second derivative, and at least 1 for the first derivative, otherwise they are zero.
+*/
+template <size_t WINDOW, size_t ORDER, size_t EVALUATION_POINT = (WINDOW - 1)/2>
+class SavitzkyGolayFilter {
+public:
+    static_assert(ORDER < WINDOW, "SavitzkyGolayFilter ORDER must be less than WINDOW");
+    static_assert(EVALUATION_POINT < WINDOW, "SavitzkyGolayFilter EVALUATION_POINT must be within the window");
+    static constexpr std::array<std::array<float, 4>, WINDOW> COEFFICIENTS = savitzkyGolayCoefficients<WINDOW, ORDER, EVALUATION_POINT>();
+    enum { VALUE = 0, DERIVATIVE = 1, SECOND_DERIVATIVE = 2 };
+public:
+    explicit SavitzkyGolayFilter(float dT = 1.0F) { setLoopTime(dT); }
+public:
+    //! Sets the sample period, which scales the derivatives.
+    inline void setLoopTime(float dT) { _dTReciprocal = 1.0F / dT; }
+    inline void reset() { _history = {}; _head = 0; _value = 0.0F; _derivative = 0.0F; _secondDerivative = 0.0F; }
+    //! Resets to the steady state for value, ie a history of constant value.
+    inline void reset(float value) { _history.fill(value); _head = 0; _value = value; _derivative = 0.0F; _secondDerivative = 0.0F; }
+    //! Returns the coefficient of the sample t samples ago, for output VALUE, DERIVATIVE or SECOND_DERIVATIVE (the derivatives per sample period).
+    static constexpr float getCoefficient(size_t output, size_t t) { return COEFFICIENTS[t][output]; }
+
+    //! Adds input to the history, and returns the smoothed value. The derivatives are then available from getDerivative() and getSecondDerivative().
+    inline float filter(float input);
+    inline float getValue() const { return _value; }
+    inline float getDerivative() const { return _derivative; }
+    inline float getSecondDerivative() const { return _secondDerivative; }
+private:
+    //! History stored twice, so the most recent WINDOW samples are contiguous from _head, newest first.
+    std::array<float, 2*WINDOW> _history {};
+    size_t _head {0}; //!< Position of the most recent sample
+    float _dTReciprocal {1.0F};
+    float _value {0.0F};
+    float _derivative {0.0F};
+    float _secondDerivative {0.0F};
+};
+
+template <size_t WINDOW, size_t ORDER, size_t EVALUATION_POINT>
+inline float SavitzkyGolayFilter<WINDOW, ORDER, EVALUATION_POINT>::filter(float input)
+{
+    _head = (_head == 0) ? WINDOW - 1 : _head - 1;
+    _history[_head] = input;
+    _history[_head + WINDOW] = input;
+
+    const float* history = &_history[_head];
+    std::array<float, 4> sums {};
+    for (size_t t = 0; t < WINDOW; ++t) {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            sums[lane] += COEFFICIENTS[t][lane]*history[t];
+        }
+    }
+    _value = sums[VALUE];
+    _derivative = sums[DERIVATIVE]*_dTReciprocal;
+    _secondDerivative = sums[SECOND_DERIVATIVE]*_dTReciprocal*_dTReciprocal;
+    return _value;
+}
@@ -0,0 +1,367 @@
+#pragma once
+
+#include "CircularBuffer.h"
+#include "CircularBufferDynamic.h"
+#include "FilterMovingAverageDynamic.h"
+#include "Filters.h"
+#include "RollingBuffer.h"
+#include "RollingBufferDynamic.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/*!
+Compact binary snapshots of filter and buffer state, used for warm restarts and for migrating channels.
+
+Each object's snapshot starts with a one byte tag identifying the type of the object and a one byte version,
+followed by its coefficients and state. Sizes are written as uint32_t.
+Arithmetic values are written little-endian, so snapshots may be moved between hosts.
+Other (trivially copyable) types, eg xyz_t, are written as raw bytes in host order.
+
+Loading decodes directly from the caller's buffer without any intermediate copy or allocation.
+On little-endian hosts each value is a single unaligned load.
+
+Snapshots are opt-in: the filter and buffer headers do not include this header, so they do not depend on it,
+instead the free functions `saveSnapshot()` and `loadSnapshot()` are defined here for each type that supports snapshots.
+This header requires C++20 (for std::endian and, via the dynamic buffers, std::span).
+*/
+enum snapshot_tag_e : uint8_t {
+    SNAPSHOT_TAG_POWER_TRANSFER_FILTER = 1,
+    SNAPSHOT_TAG_BIQUAD_FILTER = 2,
+    SNAPSHOT_TAG_MOVING_AVERAGE_FILTER = 3,
+    SNAPSHOT_TAG_ROLLING_BUFFER = 4,
+    SNAPSHOT_TAG_ROLLING_BUFFER_WITH_SUM = 5,
+    SNAPSHOT_TAG_CIRCULAR_BUFFER = 6,
+};
+static constexpr uint8_t SNAPSHOT_VERSION = 1;
+
+
+class SnapshotWriter {
+public:
+    SnapshotWriter(uint8_t* buffer, size_t size) : _buffer(buffer), _size(size) {}
+public:
+    //! Returns the number of bytes written.
+    inline size_t size() const { return _pos; }
+    //! Returns false if the buffer was too small for the data written.
+    inline bool isOK() const { return _ok; }
+
+    inline void writeHeader(uint8_t tag) { write(tag); write(SNAPSHOT_VERSION); }
+    template <typename T>
+    inline void write(const T& value);
+private:
+    uint8_t* _buffer;
+    size_t _size;
+    size_t _pos {0};
+    bool _ok {true};
+};
+
+template <typename T>
+inline void SnapshotWriter::write(const T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Snapshot values must be trivially copyable");
+    if (!_ok || _size - _pos < sizeof(T)) {
+        _ok = false;
+        return;
+    }
+    if constexpr (std::is_arithmetic_v<T> && std::endian::native == std::endian::big) {
+        uint8_t bytes[sizeof(T)];
+        memcpy(&bytes[0], &value, sizeof(T));
+        for (size_t ii = 0; ii < sizeof(T); ++ii) {
+            _buffer[_pos + ii] = bytes[sizeof(T) - 1 - ii];
+        }
+    } else {
+        memcpy(&_buffer[_pos], &value, sizeof(T));
+    }
+    _pos += sizeof(T);
+}
+
+
+class SnapshotReader {
+public:
+    SnapshotReader(const uint8_t* buffer, size_t size) : _buffer(buffer), _size(size) {}
+public:
+    //! Returns the number of bytes read.
+    inline size_t position() const { return _pos; }
+    inline size_t remaining() const { return _size - _pos; }
+
+    //! Returns true if the next object in the snapshot has the given tag and a supported version.
+    inline bool readHeader(uint8_t tag) {
+        uint8_t snapshotTag {};
+        uint8_t version {};
+        return read(snapshotTag) && read(version) && snapshotTag == tag && version == SNAPSHOT_VERSION;
+    }
+    template <typename T>
+    inline bool read(T& value);
+private:
+    const uint8_t* _buffer;
+    size_t _size;
+    size_t _pos {0};
+};
+
+template <typename T>
+inline bool SnapshotReader::read(T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Snapshot values must be trivially copyable");
+    if (_size - _pos < sizeof(T)) {
+        return false;
+    }
+    if constexpr (std::is_arithmetic_v<T> && std::endian::native == std::endian::big) {
+        uint8_t bytes[sizeof(T)];
+        for (size_t ii = 0; ii < sizeof(T); ++ii) {
+            bytes[ii] = _buffer[_pos + sizeof(T) - 1 - ii];
+        }
+        memcpy(&value, &bytes[0], sizeof(T));
+    } else {
+        memcpy(&value, &_buffer[_pos], sizeof(T));
+    }
+    _pos += sizeof(T);
+    return true;
+}
+
+
+/*!
+Implements `saveSnapshot()` and `loadSnapshot()` for each type that supports snapshots.
+Those types declare SnapshotAccess as a friend, so it can reach their state.
+
+Loading validates the tag, version, capacity or order, and length of the snapshot, and that the state it holds is one the object
+could reach itself, before modifying the object.
+Buffers are restored in logical order starting at the beginning of the buffer.
+*/
+class SnapshotAccess {
+public:
+    template <size_t N>
+    static void save(SnapshotWriter& writer, const PowerTransferFilterN<N>& filter);
+    template <size_t N>
+    static bool load(SnapshotReader& reader, PowerTransferFilterN<N>& filter);
+    static void save(SnapshotWriter& writer, const BiquadFilter& filter);
+    static bool load(SnapshotReader& reader, BiquadFilter& filter);
+    template <size_t N>
+    static void save(SnapshotWriter& writer, const FilterMovingAverage<N>& filter) { saveMovingAverage(writer, filter, N); }
+    template <size_t N>
+    static bool load(SnapshotReader& reader, FilterMovingAverage<N>& filter) { return loadMovingAverage(reader, filter, N); }
+    static void save(SnapshotWriter& writer, const FilterMovingAverageDynamic& filter) { saveMovingAverage(writer, filter, filter.windowSize()); }
+    static bool load(SnapshotReader& reader, FilterMovingAverageDynamic& filter) { return loadMovingAverage(reader, filter, filter.windowSize()); }
+
+    template <typename T, size_t C>
+    static void save(SnapshotWriter& writer, const RollingBuffer<T, C>& buffer) { saveBuffer(writer, SNAPSHOT_TAG_ROLLING_BUFFER, buffer); }
+    template <typename T, size_t C>
+    static bool load(SnapshotReader& reader, RollingBuffer<T, C>& buffer) { return loadBuffer(reader, SNAPSHOT_TAG_ROLLING_BUFFER, buffer); }
+    template <typename T>
+    static void save(SnapshotWriter& writer, const RollingBufferDynamic<T>& buffer) { saveBuffer(writer, SNAPSHOT_TAG_ROLLING_BUFFER, buffer); }
+    template <typename T>
+    static bool load(SnapshotReader& reader, RollingBufferDynamic<T>& buffer) { return loadBuffer(reader, SNAPSHOT_TAG_ROLLING_BUFFER, buffer); }
+
+    template <typename T, size_t C>
+    static void save(SnapshotWriter& writer, const RollingBufferWithSum<T, C>& buffer) { saveBufferWithSum(writer, buffer); }
+    template <typename T, size_t C>
+    static bool load(SnapshotReader& reader, RollingBufferWithSum<T, C>& buffer) { return loadBufferWithSum(reader, buffer); }
+    template <typename T>
+    static void save(SnapshotWriter& writer, const RollingBufferWithSumDynamic<T>& buffer) { saveBufferWithSum(writer, buffer); }
+    template <typename T>
+    static bool load(SnapshotReader& reader, RollingBufferWithSumDynamic<T>& buffer) { return loadBufferWithSum(reader, buffer); }
+
+    template <typename T, size_t C>
+    static void save(SnapshotWriter& writer, const CircularBuffer<T, C>& buffer) { saveBuffer(writer, SNAPSHOT_TAG_CIRCULAR_BUFFER, buffer); }
+    template <typename T, size_t C>
+    static bool load(SnapshotReader& reader, CircularBuffer<T, C>& buffer) { return loadBuffer(reader, SNAPSHOT_TAG_CIRCULAR_BUFFER, buffer); }
+    template <typename T>
+    static void save(SnapshotWriter& writer, const CircularBufferDynamic<T>& buffer) { saveBuffer(writer, SNAPSHOT_TAG_CIRCULAR_BUFFER, buffer); }
+    template <typename T>
+    static bool load(SnapshotReader& reader, CircularBufferDynamic<T>& buffer) { return loadBuffer(reader, SNAPSHOT_TAG_CIRCULAR_BUFFER, buffer); }
+private:
+    /*!
+    A moving average snapshot is rejected if its sum differs from the sum of its samples by more than this fraction of the sum
+    of their magnitudes (or by more than this amount, if the magnitudes sum to less than 1).
+    This allows for the rounding drift of the filter's running sum.
+    */
+    static constexpr double MOVING_AVERAGE_SUM_TOLERANCE = 1.0e-3;
+    // the fixed and dynamic versions of each filter and buffer have the same state, so share the same snapshot format
+    template <typename F>
+    static void saveMovingAverage(SnapshotWriter& writer, const F& filter, size_t windowSize);
+    template <typename F>
+    static bool loadMovingAverage(SnapshotReader& reader, F& filter, size_t windowSize);
+    template <typename B>
+    static void saveBuffer(SnapshotWriter& writer, uint8_t tag, const B& buffer);
+    template <typename B>
+    static bool loadBuffer(SnapshotReader& reader, uint8_t tag, B& buffer);
+    template <typename B>
+    static void saveBufferWithSum(SnapshotWriter& writer, const B& buffer);
+    template <typename B>
+    static bool loadBufferWithSum(SnapshotReader& reader, B& buffer);
+};
+
+//! Appends the coefficients and state of object to the snapshot.
+template <typename T>
+inline void saveSnapshot(SnapshotWriter& writer, const T& object) { SnapshotAccess::save(writer, object); }
+
+//! Restores object from the next object in the snapshot, returns false if the snapshot does not match the type or capacity of object.
+template <typename T>
+inline bool loadSnapshot(SnapshotReader& reader, T& object) { return SnapshotAccess::load(reader, object); }
+
+
+template <size_t N>
+inline void SnapshotAccess::save(SnapshotWriter& writer, const PowerTransferFilterN<N>& filter)
+{
+    writer.writeHeader(SNAPSHOT_TAG_POWER_TRANSFER_FILTER);
+    writer.write(static_cast<uint32_t>(N));
+    writer.write(filter._k);
+    for (const float state : filter._state) {
+        writer.write(state);
+    }
+}
+
+template <size_t N>
+inline bool SnapshotAccess::load(SnapshotReader& reader, PowerTransferFilterN<N>& filter)
+{
+    uint32_t order {};
+    if (!reader.readHeader(SNAPSHOT_TAG_POWER_TRANSFER_FILTER) || !reader.read(order) || order != N || reader.remaining() < (N + 1)*sizeof(float)) {
+        return false;
+    }
+    reader.read(filter._k);
+    for (float& state : filter._state) {
+        reader.read(state);
+    }
+    return true;
+}
+
+inline void SnapshotAccess::save(SnapshotWriter& writer, const BiquadFilter& filter)
+{
+    writer.writeHeader(SNAPSHOT_TAG_BIQUAD_FILTER);
+    const BiquadFilter::state_t& state = filter._state;
+    for (const float value : { filter._weight, filter._a1, filter._a2, filter._b0, filter._b1, filter._b2, filter._2Q_reciprocal, filter._2PiLoopTimeSeconds, state.x1, state.x2, state.y1, state.y2 }) {
+        writer.write(value);
+    }
+}
+
+inline bool SnapshotAccess::load(SnapshotReader& reader, BiquadFilter& filter)
+{
+    if (!reader.readHeader(SNAPSHOT_TAG_BIQUAD_FILTER) || reader.remaining() < 12*sizeof(float)) {
+        return false;
+    }
+    BiquadFilter::state_t& state = filter._state;
+    for (float* value : { &filter._weight, &filter._a1, &filter._a2, &filter._b0, &filter._b1, &filter._b2, &filter._2Q_reciprocal, &filter._2PiLoopTimeSeconds, &state.x1, &state.x2, &state.y1, &state.y2 }) {
+        reader.read(*value);
+    }
+    return true;
+}
+
+template <typename F>
+inline void SnapshotAccess::saveMovingAverage(SnapshotWriter& writer, const F& filter, size_t windowSize)
+{
+    writer.writeHeader(SNAPSHOT_TAG_MOVING_AVERAGE_FILTER);
+    writer.write(static_cast<uint32_t>(windowSize));
+    writer.write(static_cast<uint32_t>(filter._count));
+    writer.write(static_cast<uint32_t>(filter._index));
+    writer.write(filter._sum);
+    for (size_t ii = 0; ii < filter._count; ++ii) {
+        writer.write(filter._samples[ii]);
+    }
+}
+
+template <typename F>
+inline bool SnapshotAccess::loadMovingAverage(SnapshotReader& reader, F& filter, size_t windowSize)
+{
+    uint32_t capacity {};
+    uint32_t count {};
+    uint32_t index {};
+    if (!reader.readHeader(SNAPSHOT_TAG_MOVING_AVERAGE_FILTER) || !reader.read(capacity) || !reader.read(count) || !reader.read(index)) {
+        return false;
+    }
+    // until the window is full the samples are added in order, so the index must equal the count
+    const bool indexOK = count < capacity ? index == count : index <= count;
+    if (capacity != windowSize || count > capacity || !indexOK || reader.remaining() < sizeof(float) + count*sizeof(float)) {
+        return false;
+    }
+    // check the sum against the samples before modifying the filter
+    SnapshotReader samplesReader = reader;
+    float sum {};
+    samplesReader.read(sum);
+    double samplesSum = 0.0;
+    double samplesMagnitude = 0.0;
+    for (size_t ii = 0; ii < count; ++ii) {
+        float sample {};
+        samplesReader.read(sample);
+        samplesSum += static_cast<double>(sample);
+        samplesMagnitude += std::fabs(static_cast<double>(sample));
+    }
+    if (!(std::fabs(static_cast<double>(sum) - samplesSum) <= MOVING_AVERAGE_SUM_TOLERANCE*std::max(samplesMagnitude, 1.0))) {
+        return false;
+    }
+    filter._count = count;
+    filter._index = index;
+    reader.read(filter._sum);
+    for (size_t ii = 0; ii < count; ++ii) {
+        reader.read(filter._samples[ii]);
+    }
+    return true;
+}
+
+template <typename B>
+inline void SnapshotAccess::saveBuffer(SnapshotWriter& writer, uint8_t tag, const B& buffer)
+{
+    writer.writeHeader(tag);
+    writer.write(static_cast<uint32_t>(buffer.capacity()));
+    writer.write(static_cast<uint32_t>(buffer._size));
+    for (size_t ii = 0; ii < buffer._size; ++ii) {
+        writer.write(buffer[ii]);
+    }
+}
+
+template <typename B>
+inline bool SnapshotAccess::loadBuffer(SnapshotReader& reader, uint8_t tag, B& buffer)
+{
+    uint32_t capacity {};
+    uint32_t size {};
+    if (!reader.readHeader(tag) || !reader.read(capacity) || !reader.read(size)) {
+        return false;
+    }
+    if (capacity != buffer.capacity() || size > capacity || reader.remaining() < size*sizeof(buffer._buffer[0])) {
+        return false;
+    }
+    for (size_t ii = 0; ii < size; ++ii) {
+        reader.read(buffer._buffer[ii]);
+    }
+    buffer._begin = 0;
+    buffer._end = size;
+    buffer._size = size;
+    return true;
+}
+
+template <typename B>
+inline void SnapshotAccess::saveBufferWithSum(SnapshotWriter& writer, const B& buffer)
+{
+    writer.writeHeader(SNAPSHOT_TAG_ROLLING_BUFFER_WITH_SUM);
+    writer.write(static_cast<uint32_t>(buffer.capacity()));
+    writer.write(static_cast<uint32_t>(buffer._size));
+    writer.write(buffer._sum);
+    for (size_t ii = 0; ii < buffer._size; ++ii) {
+        writer.write(buffer[ii]);
+    }
+}
+
+template <typename B>
+inline bool SnapshotAccess::loadBufferWithSum(SnapshotReader& reader, B& buffer)
+{
+    uint32_t capacity {};
+    uint32_t size {};
+    if (!reader.readHeader(SNAPSHOT_TAG_ROLLING_BUFFER_WITH_SUM) || !reader.read(capacity) || !reader.read(size)) {
+        return false;
+    }
+    if (capacity != buffer.capacity() || size > capacity || reader.remaining() < (1 + size)*sizeof(buffer._sum)) {
+        return false;
+    }
+    reader.read(buffer._sum);
+    for (size_t ii = 0; ii < size; ++ii) {
+        reader.read(buffer._buffer[ii]);
+    }
+    buffer._begin = 0;
+    buffer._end = size;
+    buffer._size = size;
+    buffer._epochSum = {};
+    buffer._epochCount = 0;
+    return true;
+}
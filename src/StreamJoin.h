@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+/*!
+Time-alignment join of STREAMS timestamped streams, eg IMU and barometer, sampled at different and irregular times.
+
+Each stream keeps its last C (timestamp, value) samples in a ring. `interpolate()` returns the value of every stream
+at the requested timestamp, linearly interpolated between the samples either side of it.
+
+Each stream has a cursor, which is left at the sample found by the previous query. Queries are normally for
+non-decreasing timestamps, eg a fixed-rate output clock, so each cursor only moves forward, and each query is
+amortized O(1), rather than the linear search of each stream. (Earlier timestamps are also handled, by moving the cursors back.)
+
+TIME is an unsigned type, eg uint32_t microseconds, and timestamps are compared modulo 2^bits, so the timer may wrap around,
+provided the samples held span less than half its range. Timestamps within each stream must be non-decreasing.
+*/
+template <size_t STREAMS, size_t C, typename TIME = uint32_t>
+class StreamJoin {
+public:
+    static_assert(std::is_unsigned_v<TIME>, "StreamJoin TIME must be an unsigned type");
+    static_assert(C >= 2, "StreamJoin capacity must be at least 2");
+    struct item_t {
+        TIME timestamp;
+        float value;
+    };
+public:
+    inline size_t streamCount() const { return STREAMS; }
+    inline size_t capacity() const { return C; }
+    inline size_t size(size_t stream) const { return _streams[stream].end - _streams[stream].begin; }
+    inline const item_t& back(size_t stream) const { const stream_t& s = _streams[stream]; return s.items[(s.end - 1) % C]; }
+
+    //! Adds a sample to the stream. Once the stream is full its oldest sample is dropped.
+    inline void pushBack(size_t stream, TIME timestamp, float value) {
+        stream_t& s = _streams[stream];
+        assert((s.begin == s.end || !isBefore(timestamp, s.items[(s.end - 1) % C].timestamp)) && "timestamps must be non-decreasing");
+        s.items[s.end % C] = item_t { timestamp, value };
+        ++s.end;
+        if (s.end - s.begin > C) {
+            ++s.begin;
+        }
+    }
+    /*!
+    Sets value to the value of the stream at timestamp, interpolated between the samples either side of it.
+    Returns false, leaving value unchanged, if the stream does not have samples either side of timestamp,
+    ie if timestamp is before its oldest sample, or after its newest sample.
+    */
+    bool interpolate(size_t stream, TIME timestamp, float& value);
+    //! Interpolates every stream at timestamp. Returns true only if every stream could be interpolated.
+    inline bool interpolate(TIME timestamp, std::array<float, STREAMS>& values) {
+        bool ret = true;
+        for (size_t ii = 0; ii < STREAMS; ++ii) {
+            ret = interpolate(ii, timestamp, values[ii]) && ret;
+        }
+        return ret;
+    }
+    inline void clear() { for (stream_t& s : _streams) { s.begin = s.end; s.cursor = s.end; } }
+private:
+    //! Returns true if a is before b, modulo 2^bits.
+    static inline bool isBefore(TIME a, TIME b) { return static_cast<std::make_signed_t<TIME>>(static_cast<TIME>(a - b)) < 0; }
+    struct stream_t {
+        size_t begin {0}; //!< Sequence number of the oldest sample, the sample is stored at index sequence number % C.
+        size_t end {0}; //!< Sequence number of the next sample.
+        size_t cursor {0}; //!< Sequence number of the sample found by the last query.
+        std::array<item_t, C> items {};
+    };
+    std::array<stream_t, STREAMS> _streams {};
+};
+
+template <size_t STREAMS, size_t C, typename TIME>
+bool StreamJoin<STREAMS, C, TIME>::interpolate(size_t stream, TIME timestamp, float& value)
+{
+    stream_t& s = _streams[stream];
+    if (s.begin == s.end) {
+        return false;
+    }
+    size_t cursor = s.cursor < s.begin ? s.begin : (s.cursor >= s.end ? s.end - 1 : s.cursor);
+    // move forward to the last sample at or before timestamp
+    while (cursor + 1 < s.end && !isBefore(timestamp, s.items[(cursor + 1) % C].timestamp)) {
+        ++cursor;
+    }
+    // or back, if timestamp is earlier than the previous query
+    while (cursor > s.begin && isBefore(timestamp, s.items[cursor % C].timestamp)) {
+        --cursor;
+    }
+    s.cursor = cursor;
+    const item_t& before = s.items[cursor % C];
+    if (isBefore(timestamp, before.timestamp)) {
+        return false; // before the oldest sample
+    }
+    if (timestamp == before.timestamp) {
+        value = before.value;
+        return true;
+    }
+    if (cursor + 1 == s.end) {
+        return false; // after the newest sample
+    }
+    const item_t& after = s.items[(cursor + 1) % C];
+    const auto fraction = static_cast<float>(static_cast<TIME>(timestamp - before.timestamp)) / static_cast<float>(static_cast<TIME>(after.timestamp - before.timestamp));
+    value = before.value + (after.value - before.value)*fraction;
+    return true;
+}
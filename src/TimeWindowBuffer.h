@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+/*!
+Ring of (timestamp, value) pairs that holds the values within a time window, eg the last 500ms,
+for irregularly sampled data. Holds at most C values, once full the oldest values fall off the front.
+
+Values expire when they are older than the window duration, which happens in `pushBack()` and `expire()`, in amortized O(1).
+The sum, mean, min, and max of the values in the window are all O(1): the sum is maintained as values are added and expire,
+and the min and max are maintained using monotonic queues of the values that could still become the min or max.
+
+Timestamps must be non-decreasing. TIME is an unsigned type, eg uint32_t microseconds from a free-running timer,
+and timestamp differences are taken modulo 2^bits, so the timer may wrap around.
+SUM is the type of the sum, eg double for long windows of float values.
+*/
+template <typename T, size_t C, typename TIME = uint32_t, typename SUM = T>
+class TimeWindowBuffer {
+public:
+    static_assert(std::is_unsigned_v<TIME>, "TimeWindowBuffer TIME must be an unsigned type");
+    static_assert(C > 0, "TimeWindowBuffer capacity must be greater than zero");
+    struct item_t {
+        TIME timestamp;
+        T value;
+    };
+public:
+    explicit TimeWindowBuffer(TIME windowDuration) : _windowDuration(windowDuration) {}
+public:
+    inline TIME getWindowDuration() const { return _windowDuration; }
+    //! Sets the window duration, values that are now outside the window expire at the next `pushBack()` or `expire()`.
+    inline void setWindowDuration(TIME windowDuration) { _windowDuration = windowDuration; }
+    inline size_t size() const { return _end - _begin; }
+    inline bool isEmpty() const { return _end == _begin; }
+    inline size_t capacity() const { return C; }
+    inline const item_t& front() const { return _items[_begin % C]; }
+    inline const item_t& back() const { return _items[(_end - 1) % C]; }
+    //! Returns the index-th item, index 0 is the oldest.
+    inline const item_t& operator[](size_t index) const { return _items[(_begin + index) % C]; }
+
+    inline SUM sum() const { return _sum; }
+    inline SUM mean() const { return isEmpty() ? SUM {} : _sum / static_cast<SUM>(size()); }
+    //! Returns the minimum value in the window, the window must not be empty.
+    inline const T& min() const { assert(!isEmpty()); return _items[_minQueue[_minBegin % C] % C].value; }
+    //! Returns the maximum value in the window, the window must not be empty.
+    inline const T& max() const { assert(!isEmpty()); return _items[_maxQueue[_maxBegin % C] % C].value; }
+
+    //! Adds a value with the given timestamp, and expires values that are older than the window duration at that timestamp.
+    void pushBack(TIME timestamp, const T& value);
+    //! Expires values that are older than the window duration at time now.
+    void expire(TIME now);
+    inline void clear() { _begin = _end; _minBegin = _minEnd; _maxBegin = _maxEnd; _sum = SUM {}; }
+private:
+    void popFront();
+private:
+    TIME _windowDuration;
+    SUM _sum {};
+    size_t _begin {0}; //!< Sequence number of the oldest item, the item is stored at index sequence number % C.
+    size_t _end {0}; //!< Sequence number of the next item.
+    size_t _minBegin {0};
+    size_t _minEnd {0};
+    size_t _maxBegin {0};
+    size_t _maxEnd {0};
+    std::array<item_t, C> _items {};
+    std::array<size_t, C> _minQueue {}; //!< Sequence numbers of items with increasing values, the front is the minimum.
+    std::array<size_t, C> _maxQueue {}; //!< Sequence numbers of items with decreasing values, the front is the maximum.
+};
+
+template <typename T, size_t C, typename TIME, typename SUM>
+void TimeWindowBuffer<T, C, TIME, SUM>::popFront()
+{
+    _sum -= static_cast<SUM>(_items[_begin % C].value);
+    if (_minQueue[_minBegin % C] == _begin) {
+        ++_minBegin;
+    }
+    if (_maxQueue[_maxBegin % C] == _begin) {
+        ++_maxBegin;
+    }
+    ++_begin;
+    if (_begin == _end) {
+        // reset the sum when the window is empty, so rounding errors do not accumulate
+        _sum = SUM {};
+    }
+}
+
+template <typename T, size_t C, typename TIME, typename SUM>
+void TimeWindowBuffer<T, C, TIME, SUM>::expire(TIME now)
+{
+    while (_begin != _end && static_cast<TIME>(now - _items[_begin % C].timestamp) >= _windowDuration) {
+        popFront();
+    }
+}
+
+template <typename T, size_t C, typename TIME, typename SUM>
+void TimeWindowBuffer<T, C, TIME, SUM>::pushBack(TIME timestamp, const T& value)
+{
+    expire(timestamp);
+    if (size() == C) {
+        popFront();
+    }
+    // remove the values that can no longer be the min or max, since this value is newer and at least as small, or large
+    while (_minEnd != _minBegin && !(_items[_minQueue[(_minEnd - 1) % C] % C].value < value)) {
+        --_minEnd;
+    }
+    _minQueue[_minEnd % C] = _end;
+    ++_minEnd;
+    while (_maxEnd != _maxBegin && !(value < _items[_maxQueue[(_maxEnd - 1) % C] % C].value)) {
+        --_maxEnd;
+    }
+    _maxQueue[_maxEnd % C] = _end;
+    ++_maxEnd;
+
+    _items[_end % C] = item_t { timestamp, value };
+    ++_end;
+    _sum += static_cast<SUM>(value);
+}
@@ -0,0 +1,78 @@
+#define LIBRARY_FILTERS_USE_DENORMAL_SNAP
+#include "Filters.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+/*!
+Per-sample cost of filters whose input goes quiet after an impulse, so their states decay through the subnormal range.
+The cost is measured in blocks, the minimum over several repetitions is taken for each block to discount other load on the machine.
+Reports the cost of the first block, whose states are normal, and of the slowest block.
+*/
+template <typename T, size_t N, typename INIT>
+static void reportDecayTiming(const char* name, std::array<T, N>& filters, INIT init)
+{
+    constexpr size_t BLOCK_SIZE = 500;
+    constexpr size_t BLOCK_COUNT = 40;
+    constexpr size_t REPETITION_COUNT = 5;
+    std::array<double, BLOCK_COUNT> blockNs {};
+    blockNs.fill(1.0e9);
+    float sum = 0.0F;
+    for (size_t repetition = 0; repetition < REPETITION_COUNT; ++repetition) {
+        for (T& filter : filters) {
+            init(filter);
+            filter.filter(1.0F);
+        }
+        for (double& ns : blockNs) {
+            const auto begin = std::chrono::steady_clock::now();
+            for (size_t ii = 0; ii < BLOCK_SIZE; ++ii) {
+                for (T& filter : filters) {
+                    sum += filter.filter(0.0F);
+                }
+            }
+            const auto end = std::chrono::steady_clock::now();
+            ns = std::min(ns, std::chrono::duration<double, std::nano>(end - begin).count() / (BLOCK_SIZE*N));
+        }
+    }
+    TEST_ASSERT_TRUE(sum > 0.0F);
+    const double slowestNs = *std::max_element(blockNs.begin(), blockNs.end());
+    std::array<char, 128> message {};
+    snprintf(&message[0], message.size(), "%s: %.2fns per sample with normal states, %.2fns slowest while decaying (%.1fx)",
+        name, blockNs[0], slowestNs, slowestNs/blockNs[0]);
+    TEST_MESSAGE(&message[0]);
+}
+
+static void initBiquad(BiquadFilter& filter) { filter.initLowPass(10.0F, 0.001F, 0.7071F); }
+static void initPowerTransfer(PowerTransferFilterN<3>& filter) { filter.setCutoffFrequencyAndReset(10.0F, 0.001F); }
+
+void test_biquad_decay_timing()
+{
+    static std::array<BiquadFilter, 64> filters;
+    reportDecayTiming("BiquadFilter, denormal snap", filters, initBiquad);
+}
+
+void test_power_transfer_decay_timing()
+{
+    static std::array<PowerTransferFilterN<3>, 64> filters;
+    reportDecayTiming("PowerTransferFilterN<3>, denormal snap", filters, initPowerTransfer);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_biquad_decay_timing);
+    RUN_TEST(test_power_transfer_decay_timing);
+
+    UNITY_END();
+}
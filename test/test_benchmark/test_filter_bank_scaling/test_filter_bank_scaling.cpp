@@ -0,0 +1,91 @@
+#include "FilterBank.h"
+#include "FilterBankThreadPool.h"
+#include "Filters.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <unity.h>
+#include <vector>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+namespace {
+
+constexpr size_t CHANNELS = 4096;
+constexpr size_t SAMPLES = 64;
+constexpr size_t BLOCK_COUNT = 20;
+constexpr size_t REPETITION_COUNT = 5;
+
+using bank_t = FilterBank<BiquadFilter, CHANNELS, 64>;
+
+template <typename FILTER_BLOCK>
+double timeBlocks(FILTER_BLOCK filterBlock)
+{
+    double ns = 1.0e12;
+    for (size_t repetition = 0; repetition < REPETITION_COUNT; ++repetition) {
+        const auto begin = std::chrono::steady_clock::now();
+        for (size_t ii = 0; ii < BLOCK_COUNT; ++ii) {
+            filterBlock();
+        }
+        const auto end = std::chrono::steady_clock::now();
+        ns = std::min(ns, std::chrono::duration<double, std::nano>(end - begin).count() / (BLOCK_COUNT*CHANNELS*SAMPLES));
+    }
+    return ns;
+}
+
+} // end namespace
+
+/*!
+Scaling curve of FilterBankThreadPool: the cost per channel-sample of a bank of 4096 biquads filtering blocks of 64 samples,
+against the number of threads, up to twice the number of hardware threads of this machine.
+The speedup cannot exceed the number of hardware threads, so on a machine with one core the curve is flat.
+*/
+void test_filter_bank_scaling()
+{
+    static bank_t bank;
+    for (size_t ii = 0; ii < CHANNELS; ++ii) {
+        bank[ii].initLowPass(50.0F + static_cast<float>(ii % 200), 0.001F, 0.7071F);
+    }
+    std::vector<float> input(CHANNELS*SAMPLES);
+    for (size_t ii = 0; ii < input.size(); ++ii) {
+        input[ii] = static_cast<float>(ii % 11) - 5.0F;
+    }
+    std::vector<float> output(CHANNELS*SAMPLES);
+
+    const size_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    std::array<char, 128> message {};
+    snprintf(&message[0], message.size(), "%u channels, blocks of %u samples, %u hardware threads",
+        static_cast<unsigned>(CHANNELS), static_cast<unsigned>(SAMPLES), static_cast<unsigned>(hardwareThreads));
+    TEST_MESSAGE(&message[0]);
+
+    const double singleThreadNs = timeBlocks([&]() { bank.filter(&input[0], &output[0], SAMPLES); });
+    snprintf(&message[0], message.size(), "FilterBank::filter, no pool: %.3fns per channel-sample", singleThreadNs);
+    TEST_MESSAGE(&message[0]);
+
+    for (size_t threadCount = 1; threadCount <= 2*hardwareThreads; threadCount *= 2) {
+        FilterBankThreadPool pool(threadCount);
+        const double ns = timeBlocks([&]() { pool.filter(bank, &input[0], &output[0], SAMPLES); });
+        const double speedup = singleThreadNs/ns;
+        snprintf(&message[0], message.size(), "FilterBankThreadPool, %2u threads: %.3fns per channel-sample, speedup %.2fx, efficiency %3.0f%%",
+            static_cast<unsigned>(threadCount), ns, speedup, 100.0*speedup/static_cast<double>(std::min(threadCount, hardwareThreads)));
+        TEST_MESSAGE(&message[0]);
+    }
+    TEST_ASSERT_TRUE(output[0] != 0.0F);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_filter_bank_scaling);
+
+    UNITY_END();
+}
@@ -0,0 +1,125 @@
+#include "GyroFilterChain.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+namespace {
+
+constexpr float dT = 0.000125F; // 8kHz
+constexpr size_t SAMPLE_COUNT = 8000*20;
+constexpr size_t REPETITION_COUNT = 5;
+
+// simple deterministic pseudo-random input in [-1, 1]
+float noise(uint32_t& state)
+{
+    state = state*1664525U + 1013904223U;
+    return static_cast<float>(state >> 8U)/static_cast<float>(1U << 23U) - 1.0F;
+}
+
+using chain_t = GyroFilterChain<3>;
+
+struct filters_t {
+    chain_t chain {dT};
+    std::array<PowerTransferFilter1, 3> pt1;
+    std::array<std::array<BiquadFilter, 5>, 3> notches;
+};
+
+//! PT1, 2 static notches, and 3 dynamic notches on each axis, configured identically in the chain and in the separate filters.
+void initFilters(filters_t& filters)
+{
+    filters.chain.setPowerTransferCutoffFrequency(500.0F);
+    filters.chain.setStaticNotchFrequency(0, 250.0F, 2.0F);
+    filters.chain.setStaticNotchFrequency(1, 400.0F, 2.0F);
+    for (size_t axis = 0; axis < 3; ++axis) {
+        filters.pt1[axis].setCutoffFrequencyAndReset(500.0F, dT);
+        filters.notches[axis][0].initNotch(250.0F, dT, 2.0F);
+        filters.notches[axis][1].initNotch(400.0F, dT, 2.0F);
+        for (size_t notch = 0; notch < 3; ++notch) {
+            const float frequencyHz = 150.0F + 100.0F*static_cast<float>(notch) + 10.0F*static_cast<float>(axis);
+            filters.chain.setDynamicNotchFrequency(notch, axis, frequencyHz);
+            filters.notches[axis][2 + notch].initNotch(frequencyHz, dT, filters.chain.getDynamicNotchQ());
+        }
+    }
+    for (size_t ii = 0; ii < chain_t::STAGE_COUNT; ++ii) {
+        filters.chain.setStageEnabled(ii, true);
+    }
+}
+
+} // end namespace
+
+/*!
+Cost per 3-axis sample of the fused chain against separate filters on each axis, at 8kHz.
+The chain is called one sample at a time, as in a control loop, and also for whole blocks.
+*/
+void test_gyro_filter_chain_timing()
+{
+    static filters_t filters;
+    initFilters(filters);
+    static std::array<float, 3*SAMPLE_COUNT> input {};
+    static std::array<float, 3*SAMPLE_COUNT> fused {};
+    static std::array<float, 3*SAMPLE_COUNT> fusedBlock {};
+    static std::array<float, 3*SAMPLE_COUNT> separate {};
+    uint32_t state = 3;
+    for (float& value : input) {
+        value = noise(state);
+    }
+    static chain_t chainBlock(dT);
+    chainBlock = filters.chain;
+
+    // best of several repetitions, to reduce the effect of cold caches and of other load on the machine
+    // the filters carry their state over from one repetition to the next, so the outputs still correspond
+    double fusedNs = 1.0e9;
+    double fusedBlockNs = 1.0e9;
+    double separateNs = 1.0e9;
+    for (size_t repetition = 0; repetition < REPETITION_COUNT; ++repetition) {
+        const auto fusedBegin = std::chrono::steady_clock::now();
+        for (size_t ii = 0; ii < SAMPLE_COUNT; ++ii) {
+            filters.chain.filter(&input[ii*3], &fused[ii*3]);
+        }
+        const auto fusedEnd = std::chrono::steady_clock::now();
+        chainBlock.filter(&input[0], &fusedBlock[0], SAMPLE_COUNT);
+        const auto fusedBlockEnd = std::chrono::steady_clock::now();
+        for (size_t ii = 0; ii < SAMPLE_COUNT; ++ii) {
+            for (size_t axis = 0; axis < 3; ++axis) {
+                float value = filters.pt1[axis].filter(input[ii*3 + axis]);
+                for (BiquadFilter& notch : filters.notches[axis]) {
+                    value = notch.filter(value);
+                }
+                separate[ii*3 + axis] = value;
+            }
+        }
+        const auto separateEnd = std::chrono::steady_clock::now();
+        fusedNs = std::min(fusedNs, std::chrono::duration<double, std::nano>(fusedEnd - fusedBegin).count() / SAMPLE_COUNT);
+        fusedBlockNs = std::min(fusedBlockNs, std::chrono::duration<double, std::nano>(fusedBlockEnd - fusedEnd).count() / SAMPLE_COUNT);
+        separateNs = std::min(separateNs, std::chrono::duration<double, std::nano>(separateEnd - fusedBlockEnd).count() / SAMPLE_COUNT);
+    }
+
+    for (size_t ii = 0; ii < 3*SAMPLE_COUNT; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0e-4F, separate[ii], fused[ii]);
+        TEST_ASSERT_FLOAT_WITHIN(1.0e-4F, separate[ii], fusedBlock[ii]);
+    }
+    std::array<char, 160> message {};
+    snprintf(&message[0], message.size(), "GyroFilterChain: fused %.1fns, fused block %.1fns, separate filters %.1fns per 3-axis sample (%.2fx)",
+        fusedNs, fusedBlockNs, separateNs, separateNs/fusedNs);
+    TEST_MESSAGE(&message[0]);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_gyro_filter_chain_timing);
+
+    UNITY_END();
+}
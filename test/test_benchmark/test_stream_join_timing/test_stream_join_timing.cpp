@@ -0,0 +1,153 @@
+#include "RollingBuffer.h"
+#include "StreamJoin.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+namespace {
+
+constexpr size_t CAPACITY = 64;
+constexpr size_t TICK_COUNT = 20000; // 1ms ticks
+constexpr size_t BARO_TICKS = 20; // 50Hz barometer
+constexpr size_t QUERY_TICKS = 2; // 500Hz output clock
+constexpr uint32_t QUERY_LAG_US = 25000; // output lags the newest barometer sample, so both streams bracket it
+constexpr uint32_t START_US = 0xFFFF0000U; // the timer wraps during the run
+constexpr size_t REPETITION_COUNT = 5;
+
+struct item_t {
+    uint32_t timestamp;
+    float value;
+};
+
+struct events_t {
+    std::array<uint32_t, TICK_COUNT> imuTimestamps;
+    std::array<uint32_t, TICK_COUNT / BARO_TICKS> baroTimestamps;
+};
+
+//! IMU at 1kHz and barometer at 50Hz, each timestamp jittered by up to +/-200us.
+void makeEvents(events_t& events)
+{
+    uint32_t random = 12345;
+    auto jitter = [&random]() {
+        random = random*1664525U + 1013904223U;
+        return (random >> 16U) % 401U;
+    };
+    for (size_t ii = 0; ii < TICK_COUNT; ++ii) {
+        events.imuTimestamps[ii] = START_US + static_cast<uint32_t>(ii)*1000U + jitter() - 200U;
+    }
+    for (size_t ii = 0; ii < events.baroTimestamps.size(); ++ii) {
+        events.baroTimestamps[ii] = START_US + static_cast<uint32_t>(ii*BARO_TICKS)*1000U + jitter() - 200U;
+    }
+}
+
+inline bool isBefore(uint32_t a, uint32_t b) { return static_cast<int32_t>(a - b) < 0; }
+
+//! The linear search StreamJoin replaces: scan the buffer from its oldest sample for the samples either side of timestamp.
+bool interpolateLinearSearch(const RollingBuffer<item_t, CAPACITY>& buffer, uint32_t timestamp, float& value)
+{
+    for (size_t ii = 1; ii < buffer.size(); ++ii) {
+        const item_t& after = buffer[ii];
+        if (!isBefore(after.timestamp, timestamp)) {
+            const item_t& before = buffer[ii - 1];
+            if (isBefore(timestamp, before.timestamp)) {
+                return false;
+            }
+            const auto fraction = static_cast<float>(timestamp - before.timestamp) / static_cast<float>(after.timestamp - before.timestamp);
+            value = before.value + (after.value - before.value)*fraction;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*!
+Runs the IMU and barometer events through join, interpolating both streams at every output tick.
+Returns the time per output tick, including the pushes since the previous tick, and adds the interpolated values to sum.
+*/
+template <typename JOIN>
+double runJoin(const events_t& events, JOIN join, float& sum)
+{
+    const auto begin = std::chrono::steady_clock::now();
+    for (size_t ii = 0; ii < TICK_COUNT; ++ii) {
+        join.push(0, events.imuTimestamps[ii], static_cast<float>(ii));
+        if (ii % BARO_TICKS == 0) {
+            join.push(1, events.baroTimestamps[ii / BARO_TICKS], static_cast<float>(ii));
+        }
+        if (ii % QUERY_TICKS == 0 && ii*1000U > QUERY_LAG_US + 1000U) {
+            std::array<float, 2> values {};
+            if (join.interpolate(START_US + static_cast<uint32_t>(ii)*1000U - QUERY_LAG_US, values)) {
+                sum += values[0] + values[1];
+            }
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / static_cast<double>(TICK_COUNT / QUERY_TICKS);
+}
+
+struct stream_join_t {
+    StreamJoin<2, CAPACITY>& join;
+    inline void push(size_t stream, uint32_t timestamp, float value) { join.pushBack(stream, timestamp, value); }
+    inline bool interpolate(uint32_t timestamp, std::array<float, 2>& values) { return join.interpolate(timestamp, values); }
+};
+
+struct linear_search_t {
+    std::array<RollingBuffer<item_t, CAPACITY>, 2>& buffers;
+    inline void push(size_t stream, uint32_t timestamp, float value) { buffers[stream].pushBack(item_t { timestamp, value }); }
+    inline bool interpolate(uint32_t timestamp, std::array<float, 2>& values) {
+        const bool ok0 = interpolateLinearSearch(buffers[0], timestamp, values[0]);
+        const bool ok1 = interpolateLinearSearch(buffers[1], timestamp, values[1]);
+        return ok0 && ok1;
+    }
+};
+
+} // end namespace
+
+void test_stream_join_timing()
+{
+    static events_t events;
+    makeEvents(events);
+
+    double joinNs = 1.0e9;
+    double linearNs = 1.0e9;
+    float joinSum = 0.0F;
+    float linearSum = 0.0F;
+    for (size_t repetition = 0; repetition < REPETITION_COUNT; ++repetition) {
+        static StreamJoin<2, CAPACITY> join;
+        join.clear();
+        joinSum = 0.0F;
+        joinNs = std::min(joinNs, runJoin(events, stream_join_t { join }, joinSum));
+
+        static std::array<RollingBuffer<item_t, CAPACITY>, 2> buffers;
+        buffers = {};
+        linearSum = 0.0F;
+        linearNs = std::min(linearNs, runJoin(events, linear_search_t { buffers }, linearSum));
+    }
+    // both methods interpolate the same values
+    TEST_ASSERT_TRUE(joinSum > 0.0F);
+    TEST_ASSERT_EQUAL_FLOAT(linearSum, joinSum);
+
+    std::array<char, 160> message {};
+    snprintf(&message[0], message.size(), "IMU 1kHz + baro 50Hz, output 500Hz: StreamJoin %.1fns per output, RollingBuffer linear search %.1fns per output (%.1fx)",
+        joinNs, linearNs, linearNs/joinNs);
+    TEST_MESSAGE(&message[0]);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_stream_join_timing);
+
+    UNITY_END();
+}
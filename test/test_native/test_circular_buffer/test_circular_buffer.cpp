@@ -1,4 +1,8 @@
 #include <CircularBuffer.h>
+#include <CircularBufferDynamic.h>
+#include <Snapshot.h>
+#include <memory>
+#include <vector>
 #include <unity.h>
 
 void setUp()
@@ -407,6 +411,158 @@ void test_circular_buffer_copy()
     TEST_ASSERT_EQUAL(20, buf[3]);
 }
 
+void test_circular_buffer_snapshot()
+{
+    static CircularBuffer<int, 4> cb;
+    int popped {};
+    cb.pushBack(10);
+    cb.pushBack(11);
+    cb.pushBack(12);
+    cb.popFront(popped);
+    cb.popFront(popped);
+    cb.pushBack(13);
+    cb.pushBack(14);
+
+    std::array<uint8_t, 64> buffer {};
+    SnapshotWriter writer(&buffer[0], buffer.size());
+    saveSnapshot(writer, cb);
+    TEST_ASSERT_TRUE(writer.isOK());
+
+    static CircularBuffer<int, 4> cbRestored;
+    SnapshotReader reader(&buffer[0], writer.size());
+    TEST_ASSERT_TRUE(loadSnapshot(reader, cbRestored));
+    TEST_ASSERT_EQUAL(3, cbRestored.size());
+    TEST_ASSERT_TRUE(cbRestored.popFront(popped));
+    TEST_ASSERT_EQUAL(12, popped);
+    TEST_ASSERT_TRUE(cbRestored.popFront(popped));
+    TEST_ASSERT_EQUAL(13, popped);
+    TEST_ASSERT_TRUE(cbRestored.popFront(popped));
+    TEST_ASSERT_EQUAL(14, popped);
+    TEST_ASSERT_FALSE(cbRestored.popFront(popped));
+
+    buffer[0] = SNAPSHOT_TAG_ROLLING_BUFFER;
+    SnapshotReader wrongTag(&buffer[0], writer.size());
+    TEST_ASSERT_FALSE(loadSnapshot(wrongTag, cbRestored));
+}
+
+void test_circular_buffer_dynamic()
+{
+    static std::array<int, CircularBufferDynamic<int>::storageSize(3)> storage {};
+    CircularBufferDynamic<int> cb(storage);
+    TEST_ASSERT_EQUAL(3, cb.capacity());
+
+    TEST_ASSERT_TRUE(cb.pushBack(10));
+    TEST_ASSERT_TRUE(cb.pushBack(11));
+    TEST_ASSERT_TRUE(cb.pushBack(12));
+    TEST_ASSERT_TRUE(cb.isFull());
+    TEST_ASSERT_FALSE(cb.pushBack(13));
+    int popped {};
+    TEST_ASSERT_TRUE(cb.popFront(popped));
+    TEST_ASSERT_EQUAL(10, popped);
+    TEST_ASSERT_TRUE(cb.pushBack(13));
+    TEST_ASSERT_EQUAL(11, cb[0]);
+    TEST_ASSERT_EQUAL(13, cb[2]);
+    TEST_ASSERT_EQUAL(11, cb.front());
+    TEST_ASSERT_EQUAL(13, cb.back());
+
+    std::array<int, 3> buf {};
+    cb.copy(buf);
+    TEST_ASSERT_EQUAL(11, buf[0]);
+    TEST_ASSERT_EQUAL(12, buf[1]);
+    TEST_ASSERT_EQUAL(13, buf[2]);
+}
+
+struct packet_t {
+    uint32_t timestamp;
+    std::array<float, 3> gyro;
+    std::array<float, 3> acc;
+};
+
+void test_circular_buffer_reserve_commit()
+{
+    static CircularBuffer<packet_t, 2> cb;
+    TEST_ASSERT_NULL(cb.peekFront());
+
+    packet_t* slot = cb.reserveBack();
+    TEST_ASSERT_NOT_NULL(slot);
+    slot->timestamp = 100;
+    slot->gyro[0] = 1.0F;
+    // not in the buffer until committed
+    TEST_ASSERT_EQUAL(0, cb.size());
+    cb.commitBack();
+    TEST_ASSERT_EQUAL(1, cb.size());
+
+    slot = cb.reserveBack();
+    TEST_ASSERT_NOT_NULL(slot);
+    slot->timestamp = 200;
+    cb.commitBack();
+    TEST_ASSERT_NULL(cb.reserveBack());
+    TEST_ASSERT_TRUE(cb.isFull());
+
+    // read in place
+    const packet_t* item = cb.peekFront();
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_EQUAL(100, item->timestamp);
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, item->gyro[0]);
+    TEST_ASSERT_TRUE(item == &cb.front());
+    cb.releaseFront();
+    TEST_ASSERT_EQUAL(1, cb.size());
+
+    // wrap around
+    slot = cb.reserveBack();
+    TEST_ASSERT_NOT_NULL(slot);
+    slot->timestamp = 300;
+    cb.commitBack();
+    slot = cb.reserveBack();
+    TEST_ASSERT_NULL(slot);
+
+    packet_t packet {};
+    TEST_ASSERT_TRUE(cb.popFront(packet));
+    TEST_ASSERT_EQUAL(200, packet.timestamp);
+    TEST_ASSERT_EQUAL(300, cb.peekFront()->timestamp);
+    cb.releaseFront();
+    TEST_ASSERT_TRUE(cb.isEmpty());
+    TEST_ASSERT_NULL(cb.peekFront());
+}
+ 
+void test_circular_buffer_move()
+{
+    // move-only type
+    static CircularBuffer<std::unique_ptr<int>, 3> cb;
+    TEST_ASSERT_TRUE(cb.pushBack(std::make_unique<int>(10)));
+    TEST_ASSERT_TRUE(cb.emplaceBack(new int(11))); // NOLINT(cppcoreguidelines-owning-memory)
+    auto p = std::make_unique<int>(12);
+    TEST_ASSERT_TRUE(cb.pushBack(std::move(p)));
+    TEST_ASSERT_NULL(p.get()); // NOLINT(bugprone-use-after-move,hicpp-invalid-access-moved)
+    // buffer full, so the argument is not consumed
+    auto q = std::make_unique<int>(13);
+    TEST_ASSERT_FALSE(cb.emplaceBack(std::move(q)));
+    TEST_ASSERT_NOT_NULL(q.get()); // NOLINT(bugprone-use-after-move,hicpp-invalid-access-moved)
+    TEST_ASSERT_EQUAL(13, *q);
+    std::unique_ptr<int> popped;
+    TEST_ASSERT_TRUE(cb.popFront(popped));
+    TEST_ASSERT_EQUAL(10, *popped);
+    TEST_ASSERT_TRUE(cb.popFront(popped));
+    TEST_ASSERT_EQUAL(11, *popped);
+
+    // heap-owning type: moved in and out without copying, and bulk copy is type-aware
+    static CircularBuffer<std::vector<int>, 2> cbv;
+    std::vector<int> batch {1, 2, 3};
+    const int* data = batch.data();
+    cbv.pushBack(std::move(batch));
+    TEST_ASSERT_TRUE(data == cbv.front().data());
+    cbv.emplaceBack(4, 7);
+    std::array<std::vector<int>, 2> dest {};
+    cbv.copy(dest);
+    TEST_ASSERT_EQUAL(3, dest[0].size());
+    TEST_ASSERT_EQUAL(4, dest[1].size());
+    TEST_ASSERT_EQUAL(7, dest[1][3]);
+    std::vector<int> out;
+    cbv.popFront(out);
+    TEST_ASSERT_TRUE(data == out.data());
+    TEST_ASSERT_TRUE(cbv.front().size() == 4);
+}
+
 // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
@@ -417,6 +573,10 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
     RUN_TEST(test_circular_buffer_front_back);
     RUN_TEST(test_circular_buffer_iteration);
     RUN_TEST(test_circular_buffer_copy);
+    RUN_TEST(test_circular_buffer_snapshot);
+    RUN_TEST(test_circular_buffer_dynamic);
+    RUN_TEST(test_circular_buffer_reserve_commit);
+    RUN_TEST(test_circular_buffer_move);
 
     UNITY_END();
 }
\ No newline at end of file
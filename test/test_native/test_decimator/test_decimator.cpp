@@ -0,0 +1,223 @@
+#include "Decimator.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+void test_polyphase_decimator_passthrough()
+{
+    static PolyphaseDecimator<4, 3> decimator;
+    float output = -1.0F;
+    TEST_ASSERT_FALSE(decimator.filter(1.0F, output));
+    TEST_ASSERT_FALSE(decimator.filter(2.0F, output));
+    TEST_ASSERT_FALSE(decimator.filter(3.0F, output));
+    TEST_ASSERT_EQUAL_FLOAT(-1.0F, output);
+    TEST_ASSERT_TRUE(decimator.filter(4.0F, output));
+    TEST_ASSERT_EQUAL_FLOAT(4.0F, output);
+    const std::array<float, 8> input {{ 5.0F, 6.0F, 7.0F, 8.0F, 9.0F, 10.0F, 11.0F, 12.0F }};
+    std::array<float, 2> outputs {};
+    TEST_ASSERT_EQUAL(2, decimator.filter(&input[0], &outputs[0], input.size()));
+    TEST_ASSERT_EQUAL_FLOAT(8.0F, outputs[0]);
+    TEST_ASSERT_EQUAL_FLOAT(12.0F, outputs[1]);
+}
+
+void test_polyphase_decimator_matches_fir()
+{
+    // 8kHz to 1kHz, passband to 400Hz
+    constexpr float loopTime = 1.0F / 8000.0F;
+    static PolyphaseDecimator<8, 6> decimator(400.0F, loopTime);
+    TEST_ASSERT_EQUAL(8, decimator.factor());
+
+    float sum = 0.0F;
+    for (size_t ii = 0; ii < decimator.TAP_COUNT; ++ii) {
+        sum += decimator.getCoefficient(ii);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-6F, 1.0F, sum);
+    // linear phase, so the coefficients are symmetrical
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-7F, decimator.getCoefficient(3), decimator.getCoefficient(decimator.TAP_COUNT - 4));
+
+    // outputs are the same as running the FIR at the full rate and keeping every 8th sample
+    std::vector<float> input;
+    uint32_t seed = 1;
+    for (size_t ii = 0; ii < 1000; ++ii) {
+        seed = seed * 1664525U + 1013904223U;
+        input.push_back(static_cast<float>(seed >> 8) / 16777216.0F - 0.5F);
+    }
+    std::vector<float> output(input.size() / 8);
+    // feed in uneven blocks, the phase is carried between calls
+    size_t outputCount = decimator.filter(&input[0], &output[0], 13);
+    outputCount += decimator.filter(&input[13], &output[outputCount], input.size() - 13);
+    TEST_ASSERT_EQUAL(input.size() / 8, outputCount);
+    for (size_t jj = 0; jj < outputCount; ++jj) {
+        const size_t n = jj*8 + 7;
+        float expected = 0.0F;
+        for (size_t kk = 0; kk < decimator.TAP_COUNT && kk <= n; ++kk) {
+            expected += decimator.getCoefficient(kk) * input[n - kk];
+        }
+        TEST_ASSERT_FLOAT_WITHIN(1.0e-5F, expected, output[jj]);
+    }
+}
+
+void test_polyphase_decimator_attenuation()
+{
+    constexpr float loopTime = 1.0F / 8000.0F;
+    static PolyphaseDecimator<8, 8> decimator(400.0F, loopTime);
+    auto amplitude = [&](float frequencyHz) {
+        decimator.reset();
+        float maxOutput = 0.0F;
+        float output {};
+        for (size_t ii = 0; ii < 8000; ++ii) {
+            if (decimator.filter(sinf(2.0F * 3.14159265F * frequencyHz * static_cast<float>(ii) * loopTime), output) && ii > 1000) {
+                maxOutput = std::fmax(maxOutput, std::fabs(output));
+            }
+        }
+        return maxOutput;
+    };
+    TEST_ASSERT_FLOAT_WITHIN(0.1F, 1.0F, amplitude(50.0F));
+    // would alias to 200Hz at the 1kHz output rate, but is strongly attenuated
+    TEST_ASSERT_LESS_THAN(0.01F, amplitude(1200.0F));
+    TEST_ASSERT_LESS_THAN(0.01F, amplitude(3000.0F));
+
+    decimator.reset(2.5F);
+    float output {};
+    for (size_t ii = 0; ii < 8; ++ii) {
+        decimator.filter(2.5F, output);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-5F, 2.5F, output);
+}
+static std::vector<int64_t> movingSum(const std::vector<int64_t>& input, size_t length)
+{
+    std::vector<int64_t> output(input.size());
+    int64_t sum = 0;
+    for (size_t ii = 0; ii < input.size(); ++ii) {
+        sum += input[ii];
+        if (ii >= length) {
+            sum -= input[ii - length];
+        }
+        output[ii] = sum;
+    }
+    return output;
+}
+
+void test_cic_decimator()
+{
+    // a CIC filter is equivalent to ORDER cascaded moving sums of length RATE*DELAY
+    static CICDecimator<3, 4, 2> cic;
+    static_assert(CICDecimator<3, 4, 2>::GAIN == 512);
+    std::vector<int64_t> input;
+    uint32_t seed = 1;
+    for (size_t ii = 0; ii < 400; ++ii) {
+        seed = seed * 1664525U + 1013904223U;
+        input.push_back(static_cast<int32_t>(seed >> 16U) - 32768);
+    }
+    const std::vector<int64_t> expected = movingSum(movingSum(movingSum(input, 8), 8), 8);
+    int32_t output {};
+    size_t outputCount = 0;
+    for (size_t ii = 0; ii < input.size(); ++ii) {
+        if (cic.filter(static_cast<int32_t>(input[ii]), output)) {
+            TEST_ASSERT_EQUAL(ii % 4, 3);
+            TEST_ASSERT_EQUAL(expected[ii], output);
+            ++outputCount;
+        }
+    }
+    TEST_ASSERT_EQUAL(100, outputCount);
+}
+
+void test_cic_decimator_wraparound()
+{
+    // int16_t integrators overflow continually, but the output is correct as it fits in int16_t
+    static CICDecimator<2, 8, 1, int16_t> cic;
+    static_assert(CICDecimator<2, 8, 1, int16_t>::GAIN == 64);
+    std::array<int16_t, 800> input {};
+    for (size_t ii = 0; ii < input.size(); ++ii) {
+        input[ii] = static_cast<int16_t>(ii % 50 < 25 ? 500 : -300);
+    }
+    std::array<int16_t, 100> output {};
+    TEST_ASSERT_EQUAL(100, cic.filter(&input[0], &output[0], input.size()));
+    std::vector<int64_t> input64(input.begin(), input.end());
+    const std::vector<int64_t> expected = movingSum(movingSum(input64, 8), 8);
+    for (size_t ii = 0; ii < output.size(); ++ii) {
+        TEST_ASSERT_EQUAL(expected[ii*8 + 7], output[ii]);
+    }
+    // constant input settles to input*GAIN
+    cic.reset();
+    int16_t out {};
+    for (size_t ii = 0; ii < 1000; ++ii) {
+        cic.filter(-400, out);
+    }
+    TEST_ASSERT_EQUAL(-400*64, out);
+}
+
+void test_cic_interpolator()
+{
+    // equivalent to zero-stuffing and then ORDER moving sums of length RATE*DELAY
+    static CICInterpolator<2, 4, 1> cic;
+    static_assert(CICInterpolator<2, 4, 1>::GAIN == 4);
+    std::vector<int64_t> stuffed;
+    std::vector<int32_t> output(4*50);
+    for (size_t ii = 0; ii < 50; ++ii) {
+        const auto input = static_cast<int32_t>((ii*7919) % 1000) - 500;
+        cic.filter(input, &output[ii*4]);
+        stuffed.push_back(input);
+        stuffed.push_back(0);
+        stuffed.push_back(0);
+        stuffed.push_back(0);
+    }
+    const std::vector<int64_t> expected = movingSum(movingSum(stuffed, 4), 4);
+    for (size_t ii = 0; ii < output.size(); ++ii) {
+        TEST_ASSERT_EQUAL(expected[ii], output[ii]);
+    }
+}
+
+void test_cic_compensator()
+{
+    static CICCompensator<21> compensator;
+    compensator.init(4, 16, 1, 0.2F);
+    float sum = 0.0F;
+    for (size_t ii = 0; ii < 21; ++ii) {
+        sum += compensator.getCoefficient(ii);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-5F, 1.0F, sum);
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-6F, compensator.getCoefficient(2), compensator.getCoefficient(18));
+
+    // the CIC droops by over 2dB at the passband edge, the compensated response is much flatter
+    TEST_ASSERT_LESS_THAN(0.8F, CICCompensator<21>::cicResponse(4, 16, 1, 0.2F));
+    for (float frequency = 0.0F; frequency <= 0.2F; frequency += 0.025F) {
+        float real = 0.0F;
+        float imaginary = 0.0F;
+        for (size_t ii = 0; ii < 21; ++ii) {
+            const float omega = 2.0F * 3.14159265F * frequency * static_cast<float>(ii);
+            real += compensator.getCoefficient(ii) * cosf(omega);
+            imaginary += compensator.getCoefficient(ii) * sinf(omega);
+        }
+        const float compensated = std::sqrt(real*real + imaginary*imaginary) * CICCompensator<21>::cicResponse(4, 16, 1, frequency);
+        TEST_ASSERT_FLOAT_WITHIN(0.02F, 1.0F, compensated);
+    }
+
+    compensator.reset(3.0F);
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-5F, 3.0F, compensator.filter(3.0F));
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_polyphase_decimator_passthrough);
+    RUN_TEST(test_polyphase_decimator_matches_fir);
+    RUN_TEST(test_polyphase_decimator_attenuation);
+    RUN_TEST(test_cic_decimator);
+    RUN_TEST(test_cic_decimator_wraparound);
+    RUN_TEST(test_cic_interpolator);
+    RUN_TEST(test_cic_compensator);
+
+    UNITY_END();
+}
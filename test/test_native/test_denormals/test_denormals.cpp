@@ -0,0 +1,120 @@
+#define LIBRARY_FILTERS_USE_DENORMAL_SNAP
+#include "Filters.h"
+#include "GyroFilterChain.h"
+#include <array>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+void test_denormal_snap()
+{
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, denormalSnap(1.0F));
+    TEST_ASSERT_EQUAL_FLOAT(-1.0e-19F, denormalSnap(-1.0e-19F));
+    TEST_ASSERT_TRUE(denormalSnap(1.0e-21F) == 0.0F);
+    TEST_ASSERT_TRUE(denormalSnap(-1.0e-40F) == 0.0F);
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, denormalOffset(2.0F));
+}
+
+void test_power_transfer_filterN_decay()
+{
+    PowerTransferFilterN<3> filter(10.0F, 0.001F);
+    filter.filter(1.0F);
+
+    // the decaying state never becomes subnormal and eventually is exactly zero
+    for (int ii = 0; ii < 100000; ++ii) {
+        const float output = filter.filter(0.0F);
+        TEST_ASSERT_TRUE(std::fpclassify(output) != FP_SUBNORMAL);
+    }
+    TEST_ASSERT_TRUE(filter.getState()[0] == 0.0F);
+    TEST_ASSERT_TRUE(filter.getState()[1] == 0.0F);
+    TEST_ASSERT_TRUE(filter.getState()[2] == 0.0F);
+
+    std::array<float, 8> input {};
+    std::array<float, 8> output {};
+    input[0] = 1.0F;
+    filter.filter(&input[0], &output[0], input.size());
+    input[0] = 0.0F;
+    for (int ii = 0; ii < 100000/8; ++ii) {
+        filter.filter(&input[0], &output[0], input.size());
+    }
+    TEST_ASSERT_TRUE(filter.getState()[0] == 0.0F);
+}
+
+void test_biquad_filter_decay()
+{
+    BiquadFilter filter; // NOLINT(cppcoreguidelines-init-variables)
+    filter.initLowPass(10.0F, 0.001F, 0.7071F);
+    filter.filter(1.0F);
+
+    for (int ii = 0; ii < 100000; ++ii) {
+        const float output = filter.filter(0.0F);
+        TEST_ASSERT_TRUE(std::fpclassify(output) != FP_SUBNORMAL);
+    }
+    TEST_ASSERT_TRUE(filter.getState().y1 == 0.0F);
+    TEST_ASSERT_TRUE(filter.getState().y2 == 0.0F);
+}
+
+void test_gyro_filter_chain_decay()
+{
+    // the notch states are snapped to zero on each lane, whether the chain uses SIMD or scalar code
+    static GyroFilterChain<1> chain(0.000125F);
+    chain.setStaticNotchFrequency(0, 250.0F, 2.0F);
+    chain.setStaticNotchFrequency(1, 400.0F, 2.0F);
+    for (size_t axis = 0; axis < 3; ++axis) {
+        chain.setDynamicNotchFrequency(0, axis, 300.0F + 10.0F*static_cast<float>(axis));
+    }
+    for (size_t ii = GyroFilterChain<1>::STATIC_NOTCH_0; ii < GyroFilterChain<1>::STAGE_COUNT; ++ii) {
+        chain.setStageEnabled(ii, true);
+    }
+    std::array<float, 3> input {{ 1.0F, -1.0F, 0.5F }};
+    std::array<float, 3> output {};
+    chain.filter(&input[0], &output[0]);
+    input = {};
+    for (int ii = 0; ii < 100000; ++ii) {
+        chain.filter(&input[0], &output[0]);
+        for (const float value : output) {
+            TEST_ASSERT_TRUE(std::fpclassify(value) != FP_SUBNORMAL);
+        }
+    }
+    for (const auto& notch : chain.getStages().notches) {
+        for (size_t axis = 0; axis < 3; ++axis) {
+            TEST_ASSERT_TRUE(notch.y1[axis] == 0.0F);
+            TEST_ASSERT_TRUE(notch.y2[axis] == 0.0F);
+        }
+    }
+}
+
+void test_scoped_flush_denormals()
+{
+    volatile float small = 1.0e-30F;
+    volatile float scale = 1.0e-10F;
+    TEST_ASSERT_TRUE(small*scale != 0.0F);
+    {
+        const ScopedFlushDenormals flushDenormals;
+#if defined(__SSE__) || defined(__x86_64__) || defined(__aarch64__)
+        TEST_ASSERT_TRUE(small*scale == 0.0F);
+#endif
+    }
+    // previous mode restored
+    TEST_ASSERT_TRUE(small*scale != 0.0F);
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_denormal_snap);
+    RUN_TEST(test_power_transfer_filterN_decay);
+    RUN_TEST(test_biquad_filter_decay);
+    RUN_TEST(test_gyro_filter_chain_decay);
+    RUN_TEST(test_scoped_flush_denormals);
+
+    UNITY_END();
+}
@@ -0,0 +1,107 @@
+#define LIBRARY_FILTERS_USE_DENORMAL_DC_OFFSET
+#include "Filters.h"
+#include "GyroFilterChain.h"
+#include <array>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+void test_denormal_offset()
+{
+    TEST_ASSERT_TRUE(denormalOffset(0.0F) == DENORMAL_DC_OFFSET);
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, denormalOffset(2.0F));
+    // snapping is not enabled
+    TEST_ASSERT_TRUE(denormalSnap(1.0e-40F) != 0.0F);
+}
+
+void test_power_transfer_filterN_decay()
+{
+    PowerTransferFilterN<3> filter(10.0F, 0.001F);
+    filter.filter(1.0F);
+
+    // the decaying state never becomes subnormal, it settles at the DC offset
+    for (int ii = 0; ii < 100000; ++ii) {
+        const float output = filter.filter(0.0F);
+        TEST_ASSERT_TRUE(std::fpclassify(output) != FP_SUBNORMAL);
+    }
+    for (const float state : filter.getState()) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0e-20F, DENORMAL_DC_OFFSET, state);
+        TEST_ASSERT_TRUE(std::fpclassify(state) == FP_NORMAL);
+    }
+
+    std::array<float, 8> input {};
+    std::array<float, 8> output {};
+    input[0] = 1.0F;
+    filter.filter(&input[0], &output[0], input.size());
+    input[0] = 0.0F;
+    for (int ii = 0; ii < 100000/8; ++ii) {
+        filter.filter(&input[0], &output[0], input.size());
+        for (const float value : output) {
+            TEST_ASSERT_TRUE(std::fpclassify(value) != FP_SUBNORMAL);
+        }
+    }
+    TEST_ASSERT_TRUE(std::fpclassify(filter.getState()[0]) == FP_NORMAL);
+}
+
+void test_biquad_filter_decay()
+{
+    BiquadFilter filter; // NOLINT(cppcoreguidelines-init-variables)
+    filter.initLowPass(10.0F, 0.001F, 0.7071F);
+    filter.filter(1.0F);
+
+    for (int ii = 0; ii < 100000; ++ii) {
+        const float output = filter.filter(0.0F);
+        TEST_ASSERT_TRUE(std::fpclassify(output) != FP_SUBNORMAL);
+    }
+    TEST_ASSERT_TRUE(std::fpclassify(filter.getState().y1) == FP_NORMAL);
+    TEST_ASSERT_TRUE(std::fpclassify(filter.getState().y2) == FP_NORMAL);
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-20F, DENORMAL_DC_OFFSET, filter.getState().y1);
+}
+
+void test_gyro_filter_chain_decay()
+{
+    // the notches pass DC, so the offset keeps every stage's state normal
+    static GyroFilterChain<1> chain(0.000125F);
+    chain.setPowerTransferCutoffFrequency(100.0F);
+    chain.setStaticNotchFrequency(0, 250.0F, 2.0F);
+    chain.setStaticNotchFrequency(1, 400.0F, 2.0F);
+    for (size_t axis = 0; axis < 3; ++axis) {
+        chain.setDynamicNotchFrequency(0, axis, 300.0F);
+    }
+    for (size_t ii = 0; ii < GyroFilterChain<1>::STAGE_COUNT; ++ii) {
+        chain.setStageEnabled(ii, true);
+    }
+    std::array<float, 3> input {{ 1.0F, -1.0F, 0.5F }};
+    std::array<float, 3> output {};
+    chain.filter(&input[0], &output[0]);
+    input = {};
+    for (int ii = 0; ii < 200000; ++ii) {
+        chain.filter(&input[0], &output[0]);
+        for (const float value : output) {
+            TEST_ASSERT_TRUE(std::fpclassify(value) != FP_SUBNORMAL);
+        }
+    }
+    for (size_t axis = 0; axis < 3; ++axis) {
+        TEST_ASSERT_TRUE(std::fpclassify(output[axis]) == FP_NORMAL);
+        TEST_ASSERT_TRUE(std::fpclassify(chain.getStages().powerTransfer.state[axis]) == FP_NORMAL);
+        TEST_ASSERT_TRUE(std::fpclassify(chain.getStages().notches[2].y1[axis]) == FP_NORMAL);
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_denormal_offset);
+    RUN_TEST(test_power_transfer_filterN_decay);
+    RUN_TEST(test_biquad_filter_decay);
+    RUN_TEST(test_gyro_filter_chain_decay);
+
+    UNITY_END();
+}
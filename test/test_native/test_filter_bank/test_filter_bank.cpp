@@ -0,0 +1,160 @@
+#include "FilterBank.h"
+#include "FilterBankThreadPool.h"
+#include "Filters.h"
+#include <thread>
+#include <unity.h>
+#include <vector>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+void test_filter_bank_layout()
+{
+    using bank_t = FilterBank<PowerTransferFilter1, 100, 16>;
+    static_assert(alignof(bank_t::chunk_t) == bank_t::CACHE_LINE_SIZE);
+    static_assert(sizeof(bank_t::chunk_t) % bank_t::CACHE_LINE_SIZE == 0);
+    static bank_t bank;
+    TEST_ASSERT_EQUAL(100, bank.size());
+    TEST_ASSERT_EQUAL(7, bank.chunkCount());
+    // channels in different chunks are in different cache lines
+    const auto address15 = reinterpret_cast<uintptr_t>(&bank[15]); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto address16 = reinterpret_cast<uintptr_t>(&bank[16]); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    TEST_ASSERT_TRUE(address15/bank_t::CACHE_LINE_SIZE != address16/bank_t::CACHE_LINE_SIZE);
+    TEST_ASSERT_EQUAL(0, address16 % bank_t::CACHE_LINE_SIZE);
+}
+
+void test_filter_bank_filter()
+{
+    enum { CHANNELS = 100, SAMPLES = 8 };
+    static FilterBank<PowerTransferFilter1, CHANNELS, 16> bank;
+    static std::array<PowerTransferFilter1, CHANNELS> filters;
+    for (size_t ii = 0; ii < CHANNELS; ++ii) {
+        const float cutoffFrequencyHz = 10.0F + static_cast<float>(ii);
+        bank[ii].setCutoffFrequencyAndReset(cutoffFrequencyHz, 0.001F);
+        filters[ii].setCutoffFrequencyAndReset(cutoffFrequencyHz, 0.001F);
+    }
+    std::vector<float> input(CHANNELS*SAMPLES);
+    for (size_t ii = 0; ii < input.size(); ++ii) {
+        input[ii] = static_cast<float>(ii % 7) - 3.0F;
+    }
+    std::vector<float> output(CHANNELS*SAMPLES);
+    bank.filter(&input[0], &output[0], SAMPLES);
+    for (size_t ii = 0; ii < CHANNELS; ++ii) {
+        for (size_t jj = 0; jj < SAMPLES; ++jj) {
+            TEST_ASSERT_EQUAL_FLOAT(filters[ii].filter(input[ii*SAMPLES + jj]), output[ii*SAMPLES + jj]);
+        }
+    }
+    // single sample on every channel
+    bank.filter(&input[0], &output[0]);
+    for (size_t ii = 0; ii < CHANNELS; ++ii) {
+        TEST_ASSERT_EQUAL_FLOAT(filters[ii].filter(input[ii]), output[ii]);
+    }
+}
+
+void test_filter_bank_threads()
+{
+    enum { CHANNELS = 1000, SAMPLES = 16, THREADS = 4 };
+    static FilterBank<BiquadFilter, CHANNELS, 32> bank;
+    static FilterBank<BiquadFilter, CHANNELS, 32> bankSingleThread;
+    for (size_t ii = 0; ii < CHANNELS; ++ii) {
+        const float frequencyHz = 50.0F + static_cast<float>(ii % 200);
+        bank[ii].initLowPass(frequencyHz, 0.001F, 0.7071F);
+        bankSingleThread[ii].initLowPass(frequencyHz, 0.001F, 0.7071F);
+    }
+    std::vector<float> input(CHANNELS*SAMPLES);
+    for (size_t ii = 0; ii < input.size(); ++ii) {
+        input[ii] = static_cast<float>(ii % 11) - 5.0F;
+    }
+    std::vector<float> output(CHANNELS*SAMPLES);
+    std::vector<float> outputSingleThread(CHANNELS*SAMPLES);
+
+    for (int block = 0; block < 3; ++block) {
+        std::atomic<size_t> nextChunk {0};
+        std::vector<std::thread> threads;
+        for (int ii = 0; ii < THREADS; ++ii) {
+            threads.emplace_back([&]() { bank.filterChunks(nextChunk, &input[0], &output[0], SAMPLES); });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        bankSingleThread.filter(&input[0], &outputSingleThread[0], SAMPLES);
+    }
+    for (size_t ii = 0; ii < output.size(); ++ii) {
+        TEST_ASSERT_EQUAL_FLOAT(outputSingleThread[ii], output[ii]);
+    }
+}
+
+void test_filter_bank_thread_pool()
+{
+    enum { CHANNELS = 1000, SAMPLES = 16 };
+    static FilterBank<BiquadFilter, CHANNELS, 16> bank;
+    static FilterBank<BiquadFilter, CHANNELS, 16> bankSingleThread;
+    for (size_t ii = 0; ii < CHANNELS; ++ii) {
+        const float frequencyHz = 50.0F + static_cast<float>(ii % 200);
+        bank[ii].initLowPass(frequencyHz, 0.001F, 0.7071F);
+        bankSingleThread[ii].initLowPass(frequencyHz, 0.001F, 0.7071F);
+    }
+    std::vector<float> input(CHANNELS*SAMPLES);
+    for (size_t ii = 0; ii < input.size(); ++ii) {
+        input[ii] = static_cast<float>(ii % 11) - 5.0F;
+    }
+    std::vector<float> output(CHANNELS*SAMPLES);
+    std::vector<float> outputSingleThread(CHANNELS*SAMPLES);
+
+    // more threads than this machine may have cores, so threads are preempted and their chunks are stolen
+    FilterBankThreadPool pool(8);
+    TEST_ASSERT_EQUAL(8, pool.threadCount());
+    for (int block = 0; block < 20; ++block) {
+        pool.filter(bank, &input[0], &output[0], SAMPLES);
+        bankSingleThread.filter(&input[0], &outputSingleThread[0], SAMPLES);
+        for (size_t ii = 0; ii < output.size(); ++ii) {
+            TEST_ASSERT_EQUAL_FLOAT(outputSingleThread[ii], output[ii]);
+        }
+    }
+}
+
+void test_filter_bank_thread_pool_run()
+{
+    // every chunk is run exactly once, including when there are fewer chunks than threads
+    FilterBankThreadPool pool(4);
+    for (size_t chunkCount : { 0U, 1U, 3U, 4U, 5U, 1000U }) {
+        std::vector<std::atomic<int>> runs(chunkCount);
+        for (int block = 0; block < 10; ++block) {
+            pool.run(chunkCount, [](void* context, size_t chunkIndex) {
+                static_cast<std::atomic<int>*>(context)[chunkIndex].fetch_add(1, std::memory_order_relaxed);
+            }, runs.empty() ? nullptr : &runs[0]);
+        }
+        for (const auto& run : runs) {
+            TEST_ASSERT_EQUAL(10, run.load());
+        }
+    }
+    // a pool of one thread runs everything on the calling thread
+    FilterBankThreadPool poolSingleThread(1);
+    TEST_ASSERT_EQUAL(1, poolSingleThread.threadCount());
+    std::vector<std::atomic<int>> runs(100);
+    poolSingleThread.run(runs.size(), [](void* context, size_t chunkIndex) {
+        static_cast<std::atomic<int>*>(context)[chunkIndex].fetch_add(1, std::memory_order_relaxed);
+    }, &runs[0]);
+    for (const auto& run : runs) {
+        TEST_ASSERT_EQUAL(1, run.load());
+    }
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_filter_bank_layout);
+    RUN_TEST(test_filter_bank_filter);
+    RUN_TEST(test_filter_bank_threads);
+    RUN_TEST(test_filter_bank_thread_pool);
+    RUN_TEST(test_filter_bank_thread_pool_run);
+
+    UNITY_END();
+}
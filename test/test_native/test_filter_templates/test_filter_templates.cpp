@@ -183,6 +183,47 @@ void test_power_transfer_filter1_xyz()
     TEST_ASSERT_EQUAL_FLOAT(2.0F, filter.filter({2.0F, 0.0F, 0.0F}).x);
 }
 
+void test_power_transfer_filterN_float()
+{
+    PowerTransferFilterNT<float, 3> filter;
+
+    // test that filter with default settings performs no filtering
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, filter.filter(1.0F));
+    TEST_ASSERT_EQUAL_FLOAT(-1.0F, filter.filter(-1.0F));
+
+    filter.setCutoffFrequencyAndReset(100.0F, 0.001F);
+    TEST_ASSERT_EQUAL_FLOAT(0.1682476F, filter.filter(1.0F));
+    TEST_ASSERT_EQUAL_FLOAT(0.562592F, filter.filter(2.0F));
+
+    using pt200_t = PowerTransferFilterNT<float, 200>;
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-4F, 16.97172F, pt200_t::getCutoffCorrection());
+}
+
+void test_power_transfer_filterN_xyz()
+{
+    PowerTransferFilterNT<xyz_t, 3> filter(100.0F, 0.001F);
+    PowerTransferFilterNT<xyz_t, 3> filterBlock(100.0F, 0.001F);
+
+    const std::array<xyz_t, 4> input {{ {1.0F, 2.0F, -1.0F}, {2.0F, 4.0F, -2.0F}, {0.0F, 1.0F, 3.0F}, {5.0F, -5.0F, 0.0F} }};
+    std::array<xyz_t, 4> output {};
+    filterBlock.filter(&input[0], &output[0], input.size());
+
+    xyz_t m = filter.filter(input[0]);
+    TEST_ASSERT_EQUAL_FLOAT(0.1682476F, m.x);
+    TEST_ASSERT_EQUAL_FLOAT(2.0F*0.1682476F, m.y);
+    TEST_ASSERT_EQUAL_FLOAT(-0.1682476F, m.z);
+    TEST_ASSERT_EQUAL_FLOAT(m.y, output[0].y);
+    m = filter.filter(input[1]);
+    TEST_ASSERT_EQUAL_FLOAT(0.562592F, m.x);
+    TEST_ASSERT_EQUAL_FLOAT(m.x, output[1].x);
+    for (size_t ii = 2; ii < input.size(); ++ii) {
+        m = filter.filter(input[ii]);
+        TEST_ASSERT_EQUAL_FLOAT(m.x, output[ii].x);
+        TEST_ASSERT_EQUAL_FLOAT(m.y, output[ii].y);
+        TEST_ASSERT_EQUAL_FLOAT(m.z, output[ii].z);
+    }
+}
+
 void test_biquad_filter_float()
 {
     BiquadFilterT<float> filter;
@@ -247,6 +288,76 @@ void test_biquad_filter_xyz()
     TEST_ASSERT_EQUAL_FLOAT(2.0F, filter.filterWeighted({2.0F, 0.0F, 0.0F}).x);
 }
 
+void test_differentiator_filter_xyz()
+{
+    constexpr float dT = 0.001F;
+    DifferentiatorFilterT<xyz_t> filter(100.0F, dT, 0.7071F);
+    DifferentiatorFilterT<float> filterX(100.0F, dT, 0.7071F);
+
+    // each axis is differentiated independently
+    xyz_t output {};
+    float outputX = 0.0F;
+    for (int ii = 0; ii < 200; ++ii) {
+        const float t = static_cast<float>(ii)*dT;
+        output = filter.filter(xyz_t{2.0F*t, -3.0F*t, 5.0F});
+        outputX = filterX.filter(2.0F*t);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(outputX, output.x);
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-3F, 2.0F, output.x);
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-3F, -3.0F, output.y);
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-3F, 0.0F, output.z);
+
+    const xyz_t value {1.0F, -2.0F, 3.0F};
+    filter.reset(value);
+    output = filter.filter(value);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, output.x);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, output.y);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, output.z);
+
+    // with a setpoint weight of 0, the setpoint is ignored
+    filter.reset();
+    filterX.reset();
+    filter.setSetpointWeight(0.0F);
+    output = filter.filterSetpointWeighted(xyz_t{10.0F, 10.0F, 10.0F}, xyz_t{1.0F, 0.0F, 0.0F});
+    TEST_ASSERT_EQUAL_FLOAT(filterX.filter(-1.0F), output.x);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, output.y);
+}
+
+void test_reset_to_value_xyz()
+{
+    const xyz_t value {1.0F, -2.0F, 3.0F};
+
+    PowerTransferFilter1T<xyz_t> pt1(100.0F, 0.001F);
+    pt1.reset(value);
+    TEST_ASSERT_EQUAL_FLOAT(-2.0F, pt1.filter(value).y);
+    PowerTransferFilter2T<xyz_t> pt2(100.0F, 0.001F);
+    pt2.reset(value);
+    TEST_ASSERT_EQUAL_FLOAT(-2.0F, pt2.filter(value).y);
+    PowerTransferFilter3T<xyz_t> pt3(100.0F, 0.001F);
+    pt3.reset(value);
+    TEST_ASSERT_EQUAL_FLOAT(3.0F, pt3.filter(value).z);
+    PowerTransferFilterNT<xyz_t, 4> pt4(100.0F, 0.001F);
+    pt4.reset(value);
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, pt4.filter(value).x);
+
+    BiquadFilterT<xyz_t> biquad;
+    biquad.initLowPass(100.0F, 0.001F, 0.7071F);
+    biquad.reset(value);
+    const xyz_t output = biquad.filter(value);
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, output.x);
+    TEST_ASSERT_EQUAL_FLOAT(-2.0F, output.y);
+    TEST_ASSERT_EQUAL_FLOAT(3.0F, output.z);
+
+    FilterMovingAverageT<xyz_t, 4> movingAverage;
+    movingAverage.reset(value);
+    TEST_ASSERT_EQUAL_FLOAT(3.0F, movingAverage.filter(value).z);
+    TEST_ASSERT_EQUAL_FLOAT(4.0F, movingAverage.filter(xyz_t{1.0F, -2.0F, 7.0F}).z);
+
+    FilterNullT<xyz_t> filterNull;
+    filterNull.reset(value);
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, filterNull.filter(value).x);
+}
+
 // NOLINTEND(cppcoreguidelines-init-variables,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
@@ -259,8 +370,12 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
     RUN_TEST(test_moving_average_filter_xyz);
     RUN_TEST(test_power_transfer_filter1_float);
     RUN_TEST(test_power_transfer_filter1_xyz);
+    RUN_TEST(test_power_transfer_filterN_float);
+    RUN_TEST(test_power_transfer_filterN_xyz);
     RUN_TEST(test_biquad_filter_float);
     RUN_TEST(test_biquad_filter_xyz);
+    RUN_TEST(test_differentiator_filter_xyz);
+    RUN_TEST(test_reset_to_value_xyz);
 
     UNITY_END();
 }
@@ -1,4 +1,6 @@
+#include "FilterMovingAverageDynamic.h"
 #include "Filters.h"
+#include "Snapshot.h"
 #include <unity.h>
 
 void setUp() {
@@ -127,6 +129,61 @@ void test_power_transfer_filter3()
     TEST_ASSERT_EQUAL_FLOAT(2.0F, filter.filter(2.0F));
 }
 
+void test_power_transfer_filterN()
+{
+    static_assert(PowerTransferFilterN<1>::getCutoffCorrection() == 1.0F);
+    TEST_ASSERT_EQUAL_FLOAT(1.553773974F, PowerTransferFilterN<2>::getCutoffCorrection());
+    TEST_ASSERT_EQUAL_FLOAT(1.961459177F, PowerTransferFilterN<3>::getCutoffCorrection());
+    // large orders, where 2^(1/N) is close to 1
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-4F, 16.97172F, PowerTransferFilterN<200>::getCutoffCorrection());
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-4F, 24.01204F, PowerTransferFilterN<400>::getCutoffCorrection());
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-1F, 1201.1F, static_cast<float>(powerTransferCutoffCorrection(1000000)));
+
+    PowerTransferFilterN<3> filter; // NOLINT(cppcoreguidelines-init-variables)
+
+    // test that filter with default settings performs no filtering
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, filter.filter(1.0F));
+    TEST_ASSERT_EQUAL_FLOAT(-1.0F, filter.filter(-1.0F));
+
+    // same outputs as PowerTransferFilter3
+    filter.setCutoffFrequencyAndReset(100.0F, 0.001F);
+    TEST_ASSERT_EQUAL_FLOAT(0.1682476F, filter.filter(1.0F));
+    TEST_ASSERT_EQUAL_FLOAT(0.562592F, filter.filter(2.0F));
+
+    // same outputs as PowerTransferFilter2
+    PowerTransferFilterN<2> filter2(100.0F, 0.001F);
+    TEST_ASSERT_EQUAL_FLOAT(0.2440311F, filter2.filter(1.0F));
+    TEST_ASSERT_EQUAL_FLOAT(0.735024F, filter2.filter(2.0F));
+
+    filter.setToPassthrough();
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, filter.getState()[0]);
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, filter.filter(2.0F));
+}
+
+void test_power_transfer_filterN_block()
+{
+    PowerTransferFilterN<5> filter(50.0F, 0.001F);
+    PowerTransferFilterN<5> filterBlock(50.0F, 0.001F);
+
+    std::array<float, 16> input {};
+    for (size_t ii = 0; ii < input.size(); ++ii) {
+        input[ii] = static_cast<float>(ii % 5) - 1.5F;
+    }
+    std::array<float, 16> output {};
+    // block longer than the order, then block shorter than the order
+    filterBlock.filter(&input[0], &output[0], input.size());
+    for (size_t ii = 0; ii < input.size(); ++ii) {
+        TEST_ASSERT_EQUAL_FLOAT(filter.filter(input[ii]), output[ii]);
+    }
+    filterBlock.filter(&input[0], &output[0], 3);
+    for (size_t ii = 0; ii < 3; ++ii) {
+        TEST_ASSERT_EQUAL_FLOAT(filter.filter(input[ii]), output[ii]);
+    }
+    for (size_t ii = 0; ii < 5; ++ii) {
+        TEST_ASSERT_EQUAL_FLOAT(filter.getState()[ii], filterBlock.getState()[ii]);
+    }
+}
+
 void test_biquad_filter()
 {
     BiquadFilter filter; // NOLINT(cppcoreguidelines-init-variables)
@@ -147,6 +204,347 @@ void test_biquad_filter()
     TEST_ASSERT_EQUAL_FLOAT(2.0F, filter.filterWeighted(2.0F));
 }
 
+void test_biquad_filter_shared()
+{
+    static_assert(sizeof(BiquadFilterShared) <= sizeof(BiquadFilter)/2);
+
+    BiquadFilter coefficients; // NOLINT(cppcoreguidelines-init-variables)
+    coefficients.initLowPass(100.0F, 0.001F, 0.7071F);
+    BiquadFilter filter; // NOLINT(cppcoreguidelines-init-variables)
+    filter.initLowPass(100.0F, 0.001F, 0.7071F);
+
+    std::array<BiquadFilterShared, 3> channels {};
+    for (auto& channel : channels) {
+        channel.setCoefficients(coefficients);
+    }
+    BiquadFilterShared channel(coefficients);
+    TEST_ASSERT_TRUE(&coefficients == &channel.getCoefficients());
+
+    for (int ii = 0; ii < 10; ++ii) {
+        const float input = static_cast<float>(ii % 3);
+        const float output = filter.filter(input);
+        TEST_ASSERT_EQUAL_FLOAT(output, channel.filter(input));
+        for (auto& c : channels) {
+            TEST_ASSERT_EQUAL_FLOAT(output, c.filter(input));
+        }
+    }
+
+    // retuning the shared coefficients retunes every channel
+    coefficients.setNotchFrequency(50.0F);
+    filter.setNotchFrequency(50.0F);
+    for (int ii = 0; ii < 10; ++ii) {
+        const float input = static_cast<float>(ii % 4);
+        const float output = filter.filter(input);
+        for (auto& c : channels) {
+            TEST_ASSERT_EQUAL_FLOAT(output, c.filter(input));
+        }
+    }
+
+    coefficients.setToPassthrough();
+    channel.reset();
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, channel.getState().y1);
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, channel.filter(2.0F));
+    TEST_ASSERT_EQUAL_FLOAT(3.0F, channel.filterWeighted(3.0F));
+}
+
+void test_state_variable_filter()
+{
+    StateVariableFilter filter; // NOLINT(cppcoreguidelines-init-variables)
+
+    // test that filter with default settings performs no filtering
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, filter.filter(1.0F));
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, filter.filter(1.0F));
+    TEST_ASSERT_EQUAL_FLOAT(-1.0F, filter.filter(-1.0F));
+    TEST_ASSERT_EQUAL_FLOAT(-1.0F, filter.filterNotch(-1.0F));
+
+    filter.init(100.0F, 0.001F, 0.7071F);
+    TEST_ASSERT_EQUAL_FLOAT(0.7071F, filter.getQ());
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, filter.getState().ic1eq);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, filter.getState().ic2eq);
+
+    // first output from zero state is low-pass = a3, band-pass = a2
+    const float g = filter.calculateTan(100.0F);
+    const float a1 = 1.0F/(1.0F + g*(g + 1.0F/0.7071F));
+    StateVariableFilter::outputs_t outputs = filter.filterOutputs(1.0F);
+    TEST_ASSERT_EQUAL_FLOAT(g*g*a1, outputs.lowPass);
+    TEST_ASSERT_EQUAL_FLOAT(g*a1, outputs.bandPass);
+    TEST_ASSERT_EQUAL_FLOAT(outputs.lowPass + outputs.highPass, outputs.notch);
+
+    // step response settles to DC: low-pass passes, high-pass and band-pass reject, notch passes
+    for (int ii = 0; ii < 200; ++ii) {
+        outputs = filter.filterOutputs(1.0F);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-5F, 1.0F, outputs.lowPass);
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-5F, 0.0F, outputs.bandPass);
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-5F, 0.0F, outputs.highPass);
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-5F, 1.0F, outputs.notch);
+
+    // retuning every sample keeps the filter stable: output stays bounded over a long run
+    filter.reset();
+    float maxOutput = 0.0F;
+    for (int ii = 0; ii < 100000; ++ii) {
+        filter.setFrequency(20.0F + static_cast<float>(ii % 50)*9.0F);
+        const float input = (ii % 2) ? 1.0F : -1.0F;
+        maxOutput = std::max(maxOutput, std::fabs(filter.filter(input)));
+    }
+    TEST_ASSERT_TRUE(maxOutput < 4.0F);
+
+    filter.setFrequencyFromTan(g);
+    filter.reset();
+    TEST_ASSERT_EQUAL_FLOAT(g*g*a1, filter.filter(1.0F));
+
+    filter.setToPassthrough();
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, filter.filter(1.0F));
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, filter.filter(2.0F));
+}
+
+void test_differentiator_filter()
+{
+    DifferentiatorFilter filter; // NOLINT(cppcoreguidelines-init-variables)
+
+    // test that filter with default settings is the central difference
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, filter.filter(0.0F));
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, filter.filter(2.0F));
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, filter.filter(4.0F));
+
+    constexpr float dT = 0.001F;
+    filter.init(100.0F, dT, 0.7071F);
+    TEST_ASSERT_EQUAL_FLOAT(0.7071F, filter.getQ());
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, filter.getState().x1);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, filter.getState().y1);
+
+    // a ramp of slope 3 gives a derivative of 3, once the filter has settled
+    float output = 0.0F;
+    for (int ii = 0; ii < 200; ++ii) {
+        output = filter.filter(3.0F*static_cast<float>(ii)*dT);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-3F, 3.0F, output);
+
+    // a constant has zero derivative
+    filter.reset(5.0F);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, filter.filter(5.0F));
+
+    // below the cutoff frequency the amplitude is that of the derivative, 2*PI*f, above it is attenuated
+    constexpr float PI_F = 3.14159265358979323846F;
+    auto amplitude = [&filter](float frequencyHz) {
+        filter.reset();
+        float maxOutput = 0.0F;
+        for (int ii = 0; ii < 2000; ++ii) {
+            const float y = filter.filter(sinf(2.0F*PI_F*frequencyHz*static_cast<float>(ii)*dT));
+            if (ii >= 1000) {
+                maxOutput = std::max(maxOutput, std::fabs(y));
+            }
+        }
+        return maxOutput;
+    };
+    TEST_ASSERT_FLOAT_WITHIN(0.03F*2.0F*PI_F*10.0F, 2.0F*PI_F*10.0F, amplitude(10.0F));
+    TEST_ASSERT_TRUE(amplitude(400.0F) < 0.1F*2.0F*PI_F*400.0F);
+
+    // with a setpoint weight of 0, the setpoint is ignored
+    DifferentiatorFilter measurementOnly(100.0F, dT, 0.7071F); // NOLINT(cppcoreguidelines-init-variables)
+    filter.reset();
+    filter.setSetpointWeight(0.0F);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, filter.getSetpointWeight());
+    for (int ii = 0; ii < 10; ++ii) {
+        const float measurement = static_cast<float>(ii*ii)*0.01F;
+        TEST_ASSERT_EQUAL_FLOAT(measurementOnly.filter(-measurement), filter.filterSetpointWeighted(static_cast<float>(ii % 3), measurement));
+    }
+    filter.setSetpointWeight(0.5F);
+    filter.reset();
+    measurementOnly.reset();
+    TEST_ASSERT_EQUAL_FLOAT(measurementOnly.filter(0.5F*4.0F - 1.0F), filter.filterSetpointWeighted(4.0F, 1.0F));
+
+    filter.setToPassthrough();
+    TEST_ASSERT_EQUAL_FLOAT(1000.0F, filter.filter(2.0F));
+}
+
+void test_filter_snapshots()
+{
+    std::array<uint8_t, 256> buffer {};
+    SnapshotWriter writer(&buffer[0], buffer.size());
+
+    PowerTransferFilterN<3> pt3(100.0F, 0.001F);
+    pt3.filter(1.0F);
+    BiquadFilter biquad; // NOLINT(cppcoreguidelines-init-variables)
+    biquad.initNotch(50.0F, 0.001F, 2.0F);
+    biquad.filter(1.0F);
+    biquad.filter(3.0F);
+    FilterMovingAverage<4> movingAverage;
+    movingAverage.filter(1.0F);
+    movingAverage.filter(2.0F);
+
+    saveSnapshot(writer, pt3);
+    saveSnapshot(writer, biquad);
+    saveSnapshot(writer, movingAverage);
+    TEST_ASSERT_TRUE(writer.isOK());
+    // header, order, k, and states; header, 12 floats; header, capacity, count, index, sum, and samples
+    TEST_ASSERT_EQUAL((2 + 4 + 4*4) + (2 + 12*4) + (2 + 3*4 + 4 + 2*4), writer.size());
+    // snapshots are little-endian: the order of pt3 follows the header, and k follows the order
+    TEST_ASSERT_EQUAL(SNAPSHOT_TAG_POWER_TRANSFER_FILTER, buffer[0]);
+    TEST_ASSERT_EQUAL(SNAPSHOT_VERSION, buffer[1]);
+    TEST_ASSERT_EQUAL(3, buffer[2]);
+    TEST_ASSERT_EQUAL(0, buffer[5]);
+    float k {};
+    memcpy(&k, &buffer[6], sizeof(k));
+    TEST_ASSERT_EQUAL_FLOAT(PowerTransferFilterN<3>::gainFromFrequency(100.0F, 0.001F), k);
+
+    SnapshotReader reader(&buffer[0], writer.size());
+    PowerTransferFilterN<3> pt3Restored;
+    BiquadFilter biquadRestored; // NOLINT(cppcoreguidelines-init-variables)
+    FilterMovingAverage<4> movingAverageRestored;
+    TEST_ASSERT_TRUE(loadSnapshot(reader, pt3Restored));
+    TEST_ASSERT_TRUE(loadSnapshot(reader, biquadRestored));
+    TEST_ASSERT_TRUE(loadSnapshot(reader, movingAverageRestored));
+    TEST_ASSERT_EQUAL(writer.size(), reader.position());
+
+    TEST_ASSERT_EQUAL_FLOAT(biquad.getQ(), biquadRestored.getQ());
+    for (int ii = 0; ii < 6; ++ii) {
+        const float input = static_cast<float>(ii) - 2.0F;
+        TEST_ASSERT_EQUAL_FLOAT(pt3.filter(input), pt3Restored.filter(input));
+        TEST_ASSERT_EQUAL_FLOAT(biquad.filter(input), biquadRestored.filter(input));
+        TEST_ASSERT_EQUAL_FLOAT(movingAverage.filter(input), movingAverageRestored.filter(input));
+    }
+
+    // wrong type, wrong order, and truncated snapshots are rejected
+    SnapshotReader wrongType(&buffer[0], writer.size());
+    TEST_ASSERT_FALSE(loadSnapshot(wrongType, biquadRestored));
+    SnapshotReader wrongOrder(&buffer[0], writer.size());
+    PowerTransferFilterN<2> pt2;
+    TEST_ASSERT_FALSE(loadSnapshot(wrongOrder, pt2));
+    SnapshotReader truncated(&buffer[0], 10);
+    TEST_ASSERT_FALSE(loadSnapshot(truncated, pt3Restored));
+
+    // buffer too small
+    SnapshotWriter smallWriter(&buffer[0], 8);
+    saveSnapshot(smallWriter, biquad);
+    TEST_ASSERT_FALSE(smallWriter.isOK());
+}
+
+void test_moving_average_snapshot_validation()
+{
+    // layout: tag, version, capacity, count, index, sum, samples
+    constexpr size_t INDEX_OFFSET = 2 + 4 + 4;
+    constexpr size_t SUM_OFFSET = INDEX_OFFSET + 4;
+    FilterMovingAverage<4> movingAverage;
+    movingAverage.filter(1.0F);
+    movingAverage.filter(2.0F);
+    std::array<uint8_t, 64> buffer {};
+    SnapshotWriter writer(&buffer[0], buffer.size());
+    saveSnapshot(writer, movingAverage);
+
+    FilterMovingAverage<4> restored;
+    restored.reset(8.0F);
+    // a partly filled window must have index == count, otherwise filter() would overwrite samples in the window
+    std::array<uint8_t, 64> badIndex = buffer;
+    badIndex[INDEX_OFFSET] = 1;
+    SnapshotReader badIndexReader(&badIndex[0], writer.size());
+    TEST_ASSERT_FALSE(loadSnapshot(badIndexReader, restored));
+    // the sum must match the samples
+    std::array<uint8_t, 64> badSum = buffer;
+    const float wrongSum = 4.0F;
+    memcpy(&badSum[SUM_OFFSET], &wrongSum, sizeof(wrongSum));
+    SnapshotReader badSumReader(&badSum[0], writer.size());
+    TEST_ASSERT_FALSE(loadSnapshot(badSumReader, restored));
+    // rejected snapshots leave the filter unchanged
+    TEST_ASSERT_EQUAL_FLOAT(8.0F, restored.filter(8.0F));
+
+    // the dynamic filter has the same snapshot format
+    std::array<float, 4> storage {};
+    FilterMovingAverageDynamic restoredDynamic(storage);
+    SnapshotReader reader(&buffer[0], writer.size());
+    TEST_ASSERT_TRUE(loadSnapshot(reader, restoredDynamic));
+    TEST_ASSERT_EQUAL_FLOAT(movingAverage.filter(3.0F), restoredDynamic.filter(3.0F));
+    TEST_ASSERT_EQUAL_FLOAT(movingAverage.filter(4.0F), restoredDynamic.filter(4.0F));
+
+    // once the window is full any index up to the window size is reachable, eg 0 after reset(value)
+    movingAverage.reset(5.0F);
+    SnapshotWriter fullWriter(&buffer[0], buffer.size());
+    saveSnapshot(fullWriter, movingAverage);
+    SnapshotReader fullReader(&buffer[0], fullWriter.size());
+    TEST_ASSERT_TRUE(loadSnapshot(fullReader, restoredDynamic));
+    TEST_ASSERT_EQUAL_FLOAT(movingAverage.filter(9.0F), restoredDynamic.filter(9.0F));
+}
+
+void test_reset_to_value()
+{
+    // after reset(value), a constant input of value gives an output of value immediately
+    PowerTransferFilter1 pt1(100.0F, 0.001F);
+    pt1.reset(5.0F);
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, pt1.filter(5.0F));
+    PowerTransferFilter2 pt2(100.0F, 0.001F);
+    pt2.reset(5.0F);
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, pt2.filter(5.0F));
+    PowerTransferFilter3 pt3(100.0F, 0.001F);
+    pt3.reset(5.0F);
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, pt3.filter(5.0F));
+    PowerTransferFilterN<4> pt4(100.0F, 0.001F);
+    pt4.reset(5.0F);
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, pt4.filter(5.0F));
+
+    BiquadFilter biquad; // NOLINT(cppcoreguidelines-init-variables)
+    biquad.initLowPass(100.0F, 0.001F, 0.7071F);
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, biquad.dcGain());
+    biquad.reset(5.0F);
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, biquad.filter(5.0F));
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, biquad.filter(5.0F));
+    // filter with DC gain of 0.5
+    biquad.setParameters(-0.5F, 0.0F, 0.25F, 0.0F, 0.0F);
+    TEST_ASSERT_EQUAL_FLOAT(0.5F, biquad.dcGain());
+    biquad.reset(4.0F);
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, biquad.getState().y1);
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, biquad.filter(4.0F));
+
+    BiquadFilter coefficients; // NOLINT(cppcoreguidelines-init-variables)
+    coefficients.initNotch(100.0F, 0.001F, 2.0F);
+    BiquadFilterShared shared(coefficients);
+    shared.reset(-3.0F);
+    TEST_ASSERT_EQUAL_FLOAT(-3.0F, shared.filter(-3.0F));
+
+    StateVariableFilter svf; // NOLINT(cppcoreguidelines-init-variables)
+    svf.init(100.0F, 0.001F, 0.7071F);
+    svf.reset(5.0F);
+    const StateVariableFilter::outputs_t outputs = svf.filterOutputs(5.0F);
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, outputs.lowPass);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, outputs.bandPass);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, outputs.highPass);
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, outputs.notch);
+
+    FilterMovingAverage<3> movingAverage;
+    movingAverage.reset(6.0F);
+    TEST_ASSERT_EQUAL_FLOAT(6.0F, movingAverage.filter(6.0F));
+    TEST_ASSERT_EQUAL_FLOAT(7.0F, movingAverage.filter(9.0F));
+
+    FilterNull filterNull; // NOLINT(cppcoreguidelines-init-variables)
+    filterNull.reset(1.0F);
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, filterNull.filter(2.0F));
+}
+
+void test_moving_average_filter_dynamic()
+{
+    std::array<float, 3> storage {};
+    FilterMovingAverageDynamic filter(storage);
+    TEST_ASSERT_EQUAL(3, filter.windowSize());
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, filter.filter(1.0F));
+    TEST_ASSERT_EQUAL_FLOAT(1.5F, filter.filter(2.0F));
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, filter.filter(3.0F));
+    TEST_ASSERT_EQUAL_FLOAT(3.0F, filter.filter(4.0F));
+    TEST_ASSERT_EQUAL_FLOAT(4.0F, filter.filter(5.0F));
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, filter.filter(6.0F));
+    TEST_ASSERT_EQUAL_FLOAT(7.0F, filter.filter(10.0F));
+
+    filter.reset();
+    TEST_ASSERT_EQUAL_FLOAT(4.0F, filter.filter(4.0F));
+    filter.reset(6.0F);
+    TEST_ASSERT_EQUAL_FLOAT(7.0F, filter.filter(9.0F));
+
+    std::pmr::unsynchronized_pool_resource resource;
+    FilterMovingAverageDynamic filter1000(1000, &resource);
+    for (int ii = 0; ii < 1000; ++ii) {
+        filter1000.filter(static_cast<float>(ii % 2));
+    }
+    TEST_ASSERT_EQUAL_FLOAT(0.5F, filter1000.filter(0.0F));
+}
+
 // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
@@ -158,7 +556,16 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
     RUN_TEST(test_power_transfer_filter1);
     RUN_TEST(test_power_transfer_filter2);
     RUN_TEST(test_power_transfer_filter3);
+    RUN_TEST(test_power_transfer_filterN);
+    RUN_TEST(test_power_transfer_filterN_block);
     RUN_TEST(test_biquad_filter);
+    RUN_TEST(test_biquad_filter_shared);
+    RUN_TEST(test_state_variable_filter);
+    RUN_TEST(test_differentiator_filter);
+    RUN_TEST(test_filter_snapshots);
+    RUN_TEST(test_moving_average_snapshot_validation);
+    RUN_TEST(test_reset_to_value);
+    RUN_TEST(test_moving_average_filter_dynamic);
 
     UNITY_END();
 }
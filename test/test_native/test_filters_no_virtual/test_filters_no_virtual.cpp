@@ -0,0 +1,56 @@
+#define LIBRARY_FILTERS_NO_VIRTUAL
+#include "FilterTemplates.h"
+#include "Filters.h"
+#include <type_traits>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+static_assert(std::is_trivially_copyable_v<FilterNull> && std::is_standard_layout_v<FilterNull>);
+static_assert(std::is_trivially_copyable_v<PowerTransferFilter1> && std::is_standard_layout_v<PowerTransferFilter1>);
+static_assert(std::is_trivially_copyable_v<PowerTransferFilter2> && std::is_standard_layout_v<PowerTransferFilter2>);
+static_assert(std::is_trivially_copyable_v<PowerTransferFilter3> && std::is_standard_layout_v<PowerTransferFilter3>);
+static_assert(std::is_trivially_copyable_v<PowerTransferFilterN<4>> && std::is_standard_layout_v<PowerTransferFilterN<4>>);
+static_assert(std::is_trivially_copyable_v<BiquadFilter> && std::is_standard_layout_v<BiquadFilter>);
+static_assert(std::is_trivially_copyable_v<StateVariableFilter> && std::is_standard_layout_v<StateVariableFilter>);
+static_assert(std::is_trivially_copyable_v<FilterMovingAverage<4>> && std::is_standard_layout_v<FilterMovingAverage<4>>);
+static_assert(std::is_trivially_copyable_v<PowerTransferFilter1T<float>> && std::is_standard_layout_v<PowerTransferFilter1T<float>>);
+static_assert(std::is_trivially_copyable_v<PowerTransferFilterNT<float, 3>> && std::is_standard_layout_v<PowerTransferFilterNT<float, 3>>);
+static_assert(std::is_trivially_copyable_v<BiquadFilterT<float>> && std::is_standard_layout_v<BiquadFilterT<float>>);
+static_assert(std::is_trivially_copyable_v<FilterMovingAverageT<float, 4>> && std::is_standard_layout_v<FilterMovingAverageT<float, 4>>);
+// no vtable pointer
+static_assert(sizeof(PowerTransferFilter1) == 2*sizeof(float));
+static_assert(sizeof(BiquadFilter) == 12*sizeof(float));
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+void test_filters_no_virtual()
+{
+    std::array<PowerTransferFilter1, 4> filters {};
+    for (auto& filter : filters) {
+        filter.setCutoffFrequencyAndReset(100.0F, 0.001F);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(0.3858696F, filters[0].filter(1.0F));
+    // copying a filter copies its state
+    filters[1] = filters[0];
+    TEST_ASSERT_EQUAL_FLOAT(1.008713F, filters[1].filter(2.0F));
+    // filterVirtual is still available, but is not virtual
+    TEST_ASSERT_EQUAL_FLOAT(1.008713F, filters[0].filterVirtual(2.0F));
+
+    BiquadFilterT<float> biquad;
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, biquad.filterVirtual(2.0F));
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_filters_no_virtual);
+
+    UNITY_END();
+}
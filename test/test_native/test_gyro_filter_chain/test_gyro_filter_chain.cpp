@@ -0,0 +1,244 @@
+#include "GyroFilterChain.h"
+#include <array>
+#include <cstdint>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+namespace {
+// simple deterministic pseudo-random input in [-1, 1]
+float noise(uint32_t& state)
+{
+    state = state*1664525U + 1013904223U;
+    return static_cast<float>(state >> 8U)/static_cast<float>(1U << 23U) - 1.0F;
+}
+} // namespace
+
+void test_gyro_filter_chain_passthrough()
+{
+    using chain_t = GyroFilterChain<3>;
+    static_assert(alignof(chain_t::notch_t) == 16);
+    static_assert(chain_t::STAGE_COUNT == 6);
+    static chain_t chain(0.000125F);
+    for (size_t ii = 0; ii < chain_t::STAGE_COUNT; ++ii) {
+        TEST_ASSERT_FALSE(chain.isStageEnabled(ii));
+    }
+    std::array<float, 3> input {};
+    std::array<float, 3> output {};
+    auto checkPassthrough = [&input, &output]() {
+        for (int ii = 0; ii < 8; ++ii) {
+            const auto value = static_cast<float>(ii + 1);
+            input = {{ value, -2.0F*value, 3.0F*value }};
+            chain.filter(&input[0], &output[0]);
+            TEST_ASSERT_EQUAL_FLOAT(input[0], output[0]);
+            TEST_ASSERT_EQUAL_FLOAT(input[1], output[1]);
+            TEST_ASSERT_EQUAL_FLOAT(input[2], output[2]);
+        }
+    };
+    checkPassthrough();
+
+    // enabled stages with passthrough coefficients also pass the input through
+    for (size_t ii = 0; ii < chain_t::STAGE_COUNT; ++ii) {
+        chain.setStageEnabled(ii, true);
+        TEST_ASSERT_TRUE(chain.isStageEnabled(ii));
+    }
+    checkPassthrough();
+
+    // a dynamic notch configured on only one axis leaves the other axes passing through
+    chain.setDynamicNotchFrequency(0, 0, 300.0F);
+    for (int ii = 0; ii < 8; ++ii) {
+        const auto value = static_cast<float>(ii*ii);
+        input = {{ value, value, -value }};
+        chain.filter(&input[0], &output[0]);
+        TEST_ASSERT_EQUAL_FLOAT(input[1], output[1]);
+        TEST_ASSERT_EQUAL_FLOAT(input[2], output[2]);
+    }
+    TEST_ASSERT_TRUE(output[0] != input[0]);
+
+    chain.setToPassthrough();
+    for (size_t ii = 0; ii < chain_t::STAGE_COUNT; ++ii) {
+        TEST_ASSERT_FALSE(chain.isStageEnabled(ii));
+        chain.setStageEnabled(ii, true);
+    }
+    checkPassthrough();
+}
+
+void test_gyro_filter_chain_reenable()
+{
+    // a stage's state is reset when it is enabled, but not when it is enabled again while already enabled
+    constexpr float dT = 0.000125F;
+    using chain_t = GyroFilterChain<1>;
+    static chain_t chain(dT);
+    chain.setStaticNotchFrequency(0, 250.0F, 2.0F);
+    chain.setStageEnabled(chain_t::STATIC_NOTCH_0, true);
+    static std::array<BiquadFilter, 3> notches;
+    for (BiquadFilter& notch : notches) {
+        notch.initNotch(250.0F, dT, 2.0F);
+    }
+
+    uint32_t state = 7;
+    std::array<float, 3> input {};
+    std::array<float, 3> output {};
+    auto run = [&](int count, bool enabled) {
+        for (int ii = 0; ii < count; ++ii) {
+            for (size_t axis = 0; axis < 3; ++axis) {
+                input[axis] = noise(state);
+            }
+            chain.filter(&input[0], &output[0]);
+            for (size_t axis = 0; axis < 3; ++axis) {
+                const float expected = enabled ? notches[axis].filter(input[axis]) : input[axis];
+                TEST_ASSERT_FLOAT_WITHIN(1.0e-5F, expected, output[axis]);
+            }
+        }
+    };
+    run(100, true);
+    TEST_ASSERT_TRUE(chain.getStages().notches[0].y1[0] != 0.0F);
+    // enabling an enabled stage does not reset it
+    chain.setStageEnabled(chain_t::STATIC_NOTCH_0, true);
+    TEST_ASSERT_TRUE(chain.getStages().notches[0].y1[0] != 0.0F);
+    run(10, true);
+
+    // disabled, the stage is skipped and its state is left as it was
+    chain.setStageEnabled(chain_t::STATIC_NOTCH_0, false);
+    const float y1 = chain.getStages().notches[0].y1[1];
+    run(50, false);
+    TEST_ASSERT_EQUAL_FLOAT(y1, chain.getStages().notches[0].y1[1]);
+
+    // re-enabled, the stage starts from zero state, like a freshly reset filter
+    chain.setStageEnabled(chain_t::STATIC_NOTCH_0, true);
+    for (size_t axis = 0; axis < 3; ++axis) {
+        TEST_ASSERT_EQUAL_FLOAT(0.0F, chain.getStages().notches[0].x1[axis]);
+        TEST_ASSERT_EQUAL_FLOAT(0.0F, chain.getStages().notches[0].x2[axis]);
+        TEST_ASSERT_EQUAL_FLOAT(0.0F, chain.getStages().notches[0].y1[axis]);
+        TEST_ASSERT_EQUAL_FLOAT(0.0F, chain.getStages().notches[0].y2[axis]);
+        notches[axis].reset();
+    }
+    run(100, true);
+
+    // the power transfer stage is also reset on enable
+    chain.setPowerTransferCutoffFrequency(100.0F);
+    chain.setStageEnabled(chain_t::POWER_TRANSFER, true);
+    input = {{ 1.0F, 1.0F, 1.0F }};
+    chain.setStageEnabled(chain_t::STATIC_NOTCH_0, false);
+    for (int ii = 0; ii < 100; ++ii) {
+        chain.filter(&input[0], &output[0]);
+    }
+    TEST_ASSERT_TRUE(chain.getStages().powerTransfer.state[0] > 0.5F);
+    chain.setStageEnabled(chain_t::POWER_TRANSFER, false);
+    chain.setStageEnabled(chain_t::POWER_TRANSFER, true);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, chain.getStages().powerTransfer.state[0]);
+}
+
+void test_gyro_filter_chain_matches_filters()
+{
+    // the fused chain gives the same output as separate filters on each axis
+    constexpr float dT = 0.000125F; // 8kHz
+    using chain_t = GyroFilterChain<2>;
+    static chain_t chain(dT);
+    chain.setPowerTransferCutoffFrequency(500.0F);
+    chain.setStaticNotchFrequency(0, 250.0F, 2.0F);
+    chain.setStaticNotchFrequency(1, 400.0F, 1.5F);
+    chain.setDynamicNotchQ(4.0F);
+    TEST_ASSERT_EQUAL_FLOAT(4.0F, chain.getDynamicNotchQ());
+    const std::array<std::array<float, 2>, 3> dynamicFrequencies {{ {{ 180.0F, 360.0F }}, {{ 190.0F, 380.0F }}, {{ 200.0F, 400.0F }} }};
+    for (size_t axis = 0; axis < 3; ++axis) {
+        chain.setDynamicNotchFrequency(0, axis, dynamicFrequencies[axis][0]);
+        chain.setDynamicNotchFrequency(1, axis, dynamicFrequencies[axis][1]);
+    }
+    for (size_t ii = 0; ii < chain_t::STAGE_COUNT; ++ii) {
+        chain.setStageEnabled(ii, true);
+    }
+
+    static std::array<PowerTransferFilter1, 3> pt1;
+    static std::array<std::array<BiquadFilter, 4>, 3> notches;
+    for (size_t axis = 0; axis < 3; ++axis) {
+        pt1[axis].setCutoffFrequencyAndReset(500.0F, dT);
+        notches[axis][0].initNotch(250.0F, dT, 2.0F);
+        notches[axis][1].initNotch(400.0F, dT, 1.5F);
+        notches[axis][2].initNotch(dynamicFrequencies[axis][0], dT, 4.0F);
+        notches[axis][3].initNotch(dynamicFrequencies[axis][1], dT, 4.0F);
+    }
+
+    uint32_t state = 1;
+    std::array<float, 3> input {};
+    std::array<float, 3> output {};
+    for (int ii = 0; ii < 1000; ++ii) {
+        if (ii == 500) {
+            // disable a static notch and a dynamic notch
+            chain.setStageEnabled(chain_t::STATIC_NOTCH_1, false);
+            chain.setStageEnabled(chain_t::DYNAMIC_NOTCH_0, false);
+            TEST_ASSERT_FALSE(chain.isStageEnabled(chain_t::DYNAMIC_NOTCH_0));
+            TEST_ASSERT_TRUE(chain.isStageEnabled(chain_t::DYNAMIC_NOTCH_0 + 1));
+        }
+        for (size_t axis = 0; axis < 3; ++axis) {
+            input[axis] = noise(state);
+        }
+        chain.filter(&input[0], &output[0]);
+        for (size_t axis = 0; axis < 3; ++axis) {
+            float expected = pt1[axis].filter(input[axis]);
+            for (size_t notch = 0; notch < 4; ++notch) {
+                if (ii < 500 || (notch != 1 && notch != 2)) {
+                    expected = notches[axis][notch].filter(expected);
+                }
+            }
+            TEST_ASSERT_FLOAT_WITHIN(1.0e-5F, expected, output[axis]);
+        }
+    }
+}
+
+void test_gyro_filter_chain_block()
+{
+    // a dynamic notch at the input frequency removes it, and the block filter gives the same output as the single-sample filter
+    constexpr float dT = 0.000125F;
+    constexpr float PI_F = 3.14159265358979323846F;
+    static GyroFilterChain<1> chain(dT);
+    static GyroFilterChain<1> single(dT);
+    for (size_t axis = 0; axis < 3; ++axis) {
+        chain.setDynamicNotchFrequency(0, axis, 300.0F);
+        single.setDynamicNotchFrequency(0, axis, 300.0F);
+    }
+    chain.setStageEnabled(GyroFilterChain<1>::DYNAMIC_NOTCH_0, true);
+    single.setStageEnabled(GyroFilterChain<1>::DYNAMIC_NOTCH_0, true);
+
+    constexpr size_t SAMPLE_COUNT = 4000;
+    static std::array<float, 3*SAMPLE_COUNT> input {};
+    static std::array<float, 3*SAMPLE_COUNT> output {};
+    for (size_t ii = 0; ii < SAMPLE_COUNT; ++ii) {
+        const float t = static_cast<float>(ii)*dT;
+        input[ii*3] = sinf(2.0F*PI_F*300.0F*t);
+        input[ii*3 + 1] = 0.5F;
+        input[ii*3 + 2] = -sinf(2.0F*PI_F*300.0F*t);
+    }
+    chain.filter(&input[0], &output[0], SAMPLE_COUNT);
+    std::array<float, 3> out {};
+    float maxOutput = 0.0F;
+    for (size_t ii = 0; ii < SAMPLE_COUNT; ++ii) {
+        single.filter(&input[ii*3], &out[0]);
+        TEST_ASSERT_EQUAL_FLOAT(out[0], output[ii*3]);
+        TEST_ASSERT_EQUAL_FLOAT(out[2], output[ii*3 + 2]);
+        if (ii >= SAMPLE_COUNT/2) {
+            maxOutput = std::fmax(maxOutput, std::fabs(output[ii*3]));
+            TEST_ASSERT_FLOAT_WITHIN(1.0e-4F, 0.5F, output[ii*3 + 1]);
+        }
+    }
+    TEST_ASSERT_TRUE(maxOutput < 0.01F);
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_gyro_filter_chain_passthrough);
+    RUN_TEST(test_gyro_filter_chain_reenable);
+    RUN_TEST(test_gyro_filter_chain_matches_filters);
+    RUN_TEST(test_gyro_filter_chain_block);
+
+    UNITY_END();
+}
@@ -0,0 +1,65 @@
+#define LIBRARY_FILTERS_NO_SIMD
+#include "GyroFilterChain.h"
+#include <array>
+#include <cstdint>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+void test_gyro_filter_chain_no_simd()
+{
+    // the scalar lanes, used where there is no SSE or NEON, give the same output as separate filters on each axis
+#if defined(LIBRARY_FILTERS_HAS_SSE) || defined(LIBRARY_FILTERS_HAS_NEON)
+    TEST_FAIL_MESSAGE("LIBRARY_FILTERS_NO_SIMD is defined, but SIMD is used");
+#endif
+    constexpr float dT = 0.000125F;
+    using chain_t = GyroFilterChain<1>;
+    static chain_t chain(dT);
+    chain.setPowerTransferCutoffFrequency(500.0F);
+    chain.setStaticNotchFrequency(0, 250.0F, 2.0F);
+    chain.setStaticNotchFrequency(1, 400.0F, 1.5F);
+    for (size_t axis = 0; axis < 3; ++axis) {
+        chain.setDynamicNotchFrequency(0, axis, 180.0F + 10.0F*static_cast<float>(axis));
+    }
+    for (size_t ii = 0; ii < chain_t::STAGE_COUNT; ++ii) {
+        chain.setStageEnabled(ii, ii != chain_t::STATIC_NOTCH_1);
+    }
+
+    static std::array<PowerTransferFilter1, 3> pt1;
+    static std::array<std::array<BiquadFilter, 2>, 3> notches;
+    for (size_t axis = 0; axis < 3; ++axis) {
+        pt1[axis].setCutoffFrequencyAndReset(500.0F, dT);
+        notches[axis][0].initNotch(250.0F, dT, 2.0F);
+        notches[axis][1].initNotch(180.0F + 10.0F*static_cast<float>(axis), dT, chain.getDynamicNotchQ());
+    }
+
+    uint32_t state = 1;
+    std::array<float, 3> input {};
+    std::array<float, 3> output {};
+    for (int ii = 0; ii < 1000; ++ii) {
+        for (size_t axis = 0; axis < 3; ++axis) {
+            state = state*1664525U + 1013904223U;
+            input[axis] = static_cast<float>(state >> 8U)/static_cast<float>(1U << 23U) - 1.0F;
+        }
+        chain.filter(&input[0], &output[0]);
+        for (size_t axis = 0; axis < 3; ++axis) {
+            const float expected = notches[axis][1].filter(notches[axis][0].filter(pt1[axis].filter(input[axis])));
+            TEST_ASSERT_FLOAT_WITHIN(1.0e-5F, expected, output[axis]);
+        }
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_gyro_filter_chain_no_simd);
+
+    UNITY_END();
+}
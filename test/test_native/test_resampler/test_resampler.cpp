@@ -0,0 +1,106 @@
+#include "Resampler.h"
+#include <cmath>
+#include <vector>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+void test_farrow_resampler_unity()
+{
+    static FarrowResampler resampler;
+    float output {};
+    resampler.pushBack(1.0F);
+    resampler.pushBack(2.0F);
+    resampler.pushBack(3.0F);
+    TEST_ASSERT_FALSE(resampler.nextOutput(output));
+    resampler.pushBack(4.0F);
+    TEST_ASSERT_TRUE(resampler.nextOutput(output));
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, output);
+    TEST_ASSERT_FALSE(resampler.nextOutput(output));
+    resampler.pushBack(5.0F);
+    TEST_ASSERT_TRUE(resampler.nextOutput(output));
+    TEST_ASSERT_EQUAL_FLOAT(3.0F, output);
+    TEST_ASSERT_FALSE(resampler.nextOutput(output));
+}
+
+void test_farrow_resampler_cubic_exact()
+{
+    // cubic interpolation is exact for a cubic polynomial
+    auto cubic = [](float t) { return 0.5F*t*t*t - 2.0F*t*t + t - 3.0F; };
+    static FarrowResampler resampler(0.3F);
+    std::vector<float> input;
+    for (size_t ii = 0; ii < 20; ++ii) {
+        input.push_back(cubic(static_cast<float>(ii)));
+    }
+    std::vector<float> output(resampler.maxOutputCount(input.size()));
+    const size_t outputCount = resampler.filter(&input[0], &output[0], input.size());
+    // outputs at 1 + 0.3k for 1 + 0.3k < 18, the second newest sample
+    TEST_ASSERT_EQUAL(57, outputCount);
+    for (size_t ii = 0; ii < outputCount; ++ii) {
+        // the first output is at input sample 1
+        const float t = 1.0F + 0.3F*static_cast<float>(ii);
+        TEST_ASSERT_FLOAT_WITHIN(1.0e-3F, cubic(t), output[ii]);
+    }
+}
+
+void test_farrow_resampler_sine()
+{
+    // resample a 10Hz sine from 833Hz to 1kHz
+    constexpr float PI_F = 3.14159265F;
+    static FarrowResampler resampler(833.0F / 1000.0F);
+    constexpr double inputPeriod = 1.0 / 833.0;
+    float maxError = 0.0F;
+    size_t outputCount = 0;
+    for (size_t ii = 0; ii < 2000; ++ii) {
+        resampler.pushBack(sinf(2.0F*PI_F*10.0F*static_cast<float>(static_cast<double>(ii)*inputPeriod)));
+        float output {};
+        while (resampler.nextOutput(output)) {
+            // the first output is at the second input sample
+            const double outputTime = inputPeriod + 0.001*static_cast<double>(outputCount);
+            maxError = std::fmax(maxError, std::fabs(output - sinf(2.0F*PI_F*10.0F*static_cast<float>(outputTime))));
+            ++outputCount;
+        }
+    }
+    TEST_ASSERT_LESS_THAN(1.0e-4F, maxError);
+    TEST_ASSERT_FLOAT_WITHIN(2.0F, 1997.0F*1000.0F/833.0F, static_cast<float>(outputCount));
+}
+
+void test_farrow_resampler_drifting_ratio()
+{
+    // the input is a ramp, so each output is its position in input samples, and the positions advance by the ratio
+    static FarrowResampler resampler(1.1F);
+    std::array<float, 100> input {};
+    for (size_t ii = 0; ii < input.size(); ++ii) {
+        input[ii] = static_cast<float>(ii);
+    }
+    std::array<float, 200> output {};
+    size_t outputCount = resampler.filter(&input[0], &output[0], 50);
+    TEST_ASSERT_TRUE(outputCount <= resampler.maxOutputCount(50));
+    resampler.setRatio(0.7F);
+    const size_t firstCount = outputCount;
+    outputCount += resampler.filter(&input[50], &output[outputCount], 50);
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, output[0]);
+    for (size_t ii = 1; ii < outputCount; ++ii) {
+        const float ratio = ii <= firstCount ? 1.1F : 0.7F;
+        TEST_ASSERT_FLOAT_WITHIN(1.0e-4F, ratio, output[ii] - output[ii - 1]);
+    }
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_farrow_resampler_unity);
+    RUN_TEST(test_farrow_resampler_cubic_exact);
+    RUN_TEST(test_farrow_resampler_sine);
+    RUN_TEST(test_farrow_resampler_drifting_ratio);
+
+    UNITY_END();
+}
@@ -1,4 +1,7 @@
 #include <RollingBuffer.h>
+#include <RollingBufferDynamic.h>
+#include <Snapshot.h>
+#include <string>
 #include <unity.h>
 
 void setUp()
@@ -410,6 +413,193 @@ void test_rolling_buffer_sum()
     TEST_ASSERT_EQUAL(62, rb.sum());
 }
 
+void test_rolling_buffer_snapshot()
+{
+    static RollingBuffer<int, 4> rb;
+    static RollingBufferWithSum<int, 4> rbs;
+    for (int ii = 10; ii < 16; ++ii) {
+        rb.pushBack(ii);
+        rbs.pushBack(ii);
+    }
+    std::array<uint8_t, 128> buffer {};
+    SnapshotWriter writer(&buffer[0], buffer.size());
+    saveSnapshot(writer, rb);
+    saveSnapshot(writer, rbs);
+    TEST_ASSERT_TRUE(writer.isOK());
+    TEST_ASSERT_EQUAL(2 + 4 + 4 + 4*4 + 2 + 4 + 4 + 4 + 4*4, writer.size());
+
+    static RollingBuffer<int, 4> rbRestored;
+    static RollingBufferWithSum<int, 4> rbsRestored;
+    SnapshotReader reader(&buffer[0], writer.size());
+    TEST_ASSERT_TRUE(loadSnapshot(reader, rbRestored));
+    TEST_ASSERT_TRUE(loadSnapshot(reader, rbsRestored));
+    TEST_ASSERT_EQUAL(4, rbRestored.size());
+    TEST_ASSERT_EQUAL(12, rbRestored.front());
+    TEST_ASSERT_EQUAL(15, rbRestored.back());
+    TEST_ASSERT_EQUAL(54, rbsRestored.sum());
+
+    rbRestored.pushBack(16);
+    rbsRestored.pushBack(16);
+    TEST_ASSERT_EQUAL(13, rbRestored[0]);
+    TEST_ASSERT_EQUAL(16, rbRestored[3]);
+    TEST_ASSERT_EQUAL(58, rbsRestored.sum());
+    TEST_ASSERT_EQUAL(58, rbsRestored.recalculateSum());
+
+    static RollingBuffer<int, 8> rbWrongCapacity;
+    SnapshotReader wrongCapacity(&buffer[0], writer.size());
+    TEST_ASSERT_FALSE(loadSnapshot(wrongCapacity, rbWrongCapacity));
+
+    // the dynamic buffers have the same snapshot format, so may be restored from a fixed buffer of the same capacity
+    std::array<int, RollingBufferDynamic<int>::storageSize(4)> storage {};
+    std::array<int, RollingBufferWithSumDynamic<int>::storageSize(4)> storageWithSum {};
+    RollingBufferDynamic<int> rbDynamic(storage);
+    RollingBufferWithSumDynamic<int> rbsDynamic(storageWithSum);
+    SnapshotReader dynamicReader(&buffer[0], writer.size());
+    TEST_ASSERT_TRUE(loadSnapshot(dynamicReader, rbDynamic));
+    TEST_ASSERT_TRUE(loadSnapshot(dynamicReader, rbsDynamic));
+    TEST_ASSERT_EQUAL(4, rbDynamic.size());
+    TEST_ASSERT_EQUAL(12, rbDynamic.front());
+    TEST_ASSERT_EQUAL(15, rbDynamic.back());
+    TEST_ASSERT_EQUAL(54, rbsDynamic.sum());
+    std::array<uint8_t, 128> dynamicBuffer {};
+    SnapshotWriter dynamicWriter(&dynamicBuffer[0], dynamicBuffer.size());
+    saveSnapshot(dynamicWriter, rbDynamic);
+    saveSnapshot(dynamicWriter, rbsDynamic);
+    TEST_ASSERT_EQUAL(writer.size(), dynamicWriter.size());
+    TEST_ASSERT_EQUAL_MEMORY(&buffer[0], &dynamicBuffer[0], writer.size());
+}
+
+void test_rolling_buffer_dynamic()
+{
+    static std::array<int, RollingBufferDynamic<int>::storageSize(4)> storage {};
+    RollingBufferDynamic<int> rb(storage);
+    TEST_ASSERT_EQUAL(4, rb.capacity());
+    TEST_ASSERT_TRUE(rb.isEmpty());
+
+    for (int ii = 10; ii < 16; ++ii) {
+        rb.pushBack(ii);
+    }
+    TEST_ASSERT_EQUAL(4, rb.size());
+    TEST_ASSERT_EQUAL(12, rb.front());
+    TEST_ASSERT_EQUAL(15, rb.back());
+    TEST_ASSERT_EQUAL(12, rb[0]);
+    TEST_ASSERT_EQUAL(15, rb[3]);
+    int expected = 12;
+    for (int value : rb) {
+        TEST_ASSERT_EQUAL(expected, value);
+        ++expected;
+    }
+    std::array<int, 4> buf {};
+    rb.copy(buf);
+    TEST_ASSERT_EQUAL(12, buf[0]);
+    TEST_ASSERT_EQUAL(15, buf[3]);
+
+    // storage is the user's memory
+    TEST_ASSERT_EQUAL(15, storage[rb.getEnd() == 0 ? 4 : rb.getEnd() - 1]);
+}
+
+void test_rolling_buffer_dynamic_memory_resource()
+{
+    std::array<std::byte, 1024> arena {};
+    std::pmr::monotonic_buffer_resource resource(&arena[0], arena.size(), std::pmr::null_memory_resource());
+    RollingBufferWithSumDynamic<int> rb(100, &resource);
+    TEST_ASSERT_EQUAL(100, rb.capacity());
+    for (int ii = 0; ii < 150; ++ii) {
+        rb.pushBack(ii);
+    }
+    TEST_ASSERT_EQUAL(100, rb.size());
+    TEST_ASSERT_EQUAL(50, rb.front());
+    TEST_ASSERT_EQUAL(149, rb.back());
+    // sum of 50..149
+    TEST_ASSERT_EQUAL(9950, rb.sum());
+    TEST_ASSERT_EQUAL(9950, rb.recalculateSum());
+}
+
+void test_rolling_buffer_move()
+{
+    static RollingBuffer<std::string, 2> rb;
+    std::string s(100, 'a');
+    const char* data = s.data();
+    rb.pushBack(std::move(s));
+    TEST_ASSERT_TRUE(data == rb.front().data());
+    rb.emplaceBack(50, 'b');
+    rb.emplaceBack(25, 'c');
+    TEST_ASSERT_EQUAL(2, rb.size());
+    TEST_ASSERT_EQUAL(50, rb.front().size());
+    TEST_ASSERT_EQUAL('c', rb.back()[0]);
+    std::array<std::string, 2> dest {};
+    rb.copy(dest);
+    TEST_ASSERT_EQUAL(50, dest[0].size());
+    TEST_ASSERT_EQUAL(25, dest[1].size());
+}
+
+void test_rolling_buffer_with_sum_drift()
+{
+    // values with a large offset, so the running sum of a naive add/subtract implementation drifts
+    static RollingBufferWithSum<float, 100> rb;
+    std::array<float, 101> values {};
+    RollingBufferWithSumDynamic<float> rbd(values);
+    uint32_t seed = 1;
+    for (int ii = 0; ii < 5'000'000; ++ii) {
+        seed = seed * 1664525U + 1013904223U;
+        const float value = 1000.0F + static_cast<float>(seed >> 8) / 16777216.0F;
+        rb.pushBack(value);
+        rbd.pushBack(value);
+        if (ii % 99'991 == 0 || ii > 4'999'900) {
+            double exact = 0.0;
+            for (size_t jj = 0; jj < rb.size(); ++jj) {
+                exact += static_cast<double>(rb[jj]);
+            }
+            TEST_ASSERT_FLOAT_WITHIN(0.1F, static_cast<float>(exact), rb.sum());
+            TEST_ASSERT_FLOAT_WITHIN(0.1F, static_cast<float>(exact), rbd.sum());
+        }
+    }
+}
+
+void test_rolling_buffer_with_prefix_sum()
+{
+    static RollingBufferWithPrefixSum<int, 5> rb;
+    TEST_ASSERT_TRUE(rb.isEmpty());
+    TEST_ASSERT_EQUAL(0, rb.mean(0));
+    static RollingBuffer<int, 5> reference;
+    for (int ii = 1; ii <= 23; ++ii) {
+        rb.pushBack(ii*ii);
+        reference.pushBack(ii*ii);
+        TEST_ASSERT_EQUAL(reference.size(), rb.size());
+        TEST_ASSERT_EQUAL(ii*ii, rb.back());
+        for (size_t window = 0; window <= rb.size(); ++window) {
+            int expected = 0;
+            for (size_t jj = reference.size() - window; jj < reference.size(); ++jj) {
+                expected += reference[jj];
+            }
+            TEST_ASSERT_EQUAL(expected, rb.sum(window));
+        }
+    }
+    TEST_ASSERT_EQUAL((23*23 + 22*22) / 2, rb.mean(2));
+    rb.reset();
+    TEST_ASSERT_TRUE(rb.isEmpty());
+    rb.pushBack(7);
+    TEST_ASSERT_EQUAL(7, rb.sum(1));
+
+    // several window lengths of a long float stream from one buffer, the error stays bounded
+    static RollingBufferWithPrefixSum<float, 1000> rbf;
+    static RollingBuffer<float, 1000> referencef;
+    uint32_t seed = 1;
+    for (int ii = 0; ii < 1'000'000; ++ii) {
+        seed = seed * 1664525U + 1013904223U;
+        const float value = 100.0F + static_cast<float>(seed >> 8) / 16777216.0F;
+        rbf.pushBack(value);
+        referencef.pushBack(value);
+    }
+    for (size_t window : {1U, 10U, 100U, 999U, 1000U}) {
+        double exact = 0.0;
+        for (size_t jj = referencef.size() - window; jj < referencef.size(); ++jj) {
+            exact += static_cast<double>(referencef[jj]);
+        }
+        TEST_ASSERT_FLOAT_WITHIN(0.001F, static_cast<float>(exact / static_cast<double>(window)), rbf.mean(window));
+    }
+}
+
 // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
@@ -421,6 +611,12 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
     RUN_TEST(test_rolling_buffer_iteration);
     RUN_TEST(test_rolling_buffer_copy);
     RUN_TEST(test_rolling_buffer_sum);
+    RUN_TEST(test_rolling_buffer_snapshot);
+    RUN_TEST(test_rolling_buffer_dynamic);
+    RUN_TEST(test_rolling_buffer_dynamic_memory_resource);
+    RUN_TEST(test_rolling_buffer_move);
+    RUN_TEST(test_rolling_buffer_with_sum_drift);
+    RUN_TEST(test_rolling_buffer_with_prefix_sum);
 
     UNITY_END();
 }
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "RollingBufferCompressed.h"
+#include <vector>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+static int32_t adcReading(uint32_t& seed, int32_t& value)
+{
+    // slow-moving signal with a little noise
+    seed = seed * 1664525U + 1013904223U;
+    value += static_cast<int32_t>(seed >> 29U) - 3; // -3 to +4
+    return value;
+}
+
+void test_rolling_buffer_compressed()
+{
+    using buffer_t = RollingBufferCompressed<4096, 2048, 32>;
+    static buffer_t rb;
+    TEST_ASSERT_TRUE(rb.isEmpty());
+    TEST_ASSERT_EQUAL(4096, rb.capacity());
+
+    std::vector<int32_t> reference;
+    uint32_t seed = 1;
+    int32_t value = 2048;
+    for (size_t ii = 0; ii < 10000; ++ii) {
+        reference.push_back(adcReading(seed, value));
+        rb.pushBack(reference.back());
+        TEST_ASSERT_EQUAL(reference.back(), rb.back());
+        TEST_ASSERT_TRUE(rb.size() <= 4096);
+    }
+    // full, and the differences fit in 4 bits, so the pool holds the whole capacity
+    TEST_ASSERT_TRUE(rb.size() > 4096 - 32);
+    TEST_ASSERT_TRUE(rb.bytesUsed() <= 2048);
+    // more than 4 times smaller than RollingBuffer<int32_t, 4096>
+    TEST_ASSERT_TRUE(sizeof(rb) * 4 < 4096 * sizeof(int32_t));
+
+    // random access
+    const size_t offset = reference.size() - rb.size();
+    for (size_t ii = 0; ii < rb.size(); ii += 7) {
+        TEST_ASSERT_EQUAL(reference[offset + ii], rb[ii]);
+    }
+    for (size_t ii = rb.size(); ii > 0; ii -= 5) {
+        TEST_ASSERT_EQUAL(reference[offset + ii - 1], rb[ii - 1]);
+    }
+    TEST_ASSERT_EQUAL(reference[offset], rb.front());
+
+    // sequential access
+    size_t index = offset;
+    for (int32_t sample : rb) {
+        TEST_ASSERT_EQUAL(reference[index], sample);
+        ++index;
+    }
+    TEST_ASSERT_EQUAL(reference.size(), index);
+
+    std::vector<int32_t> dest(rb.size());
+    rb.copy(dest);
+    for (size_t ii = 0; ii < dest.size(); ++ii) {
+        TEST_ASSERT_EQUAL(reference[offset + ii], dest[ii]);
+    }
+
+    rb.clear();
+    TEST_ASSERT_TRUE(rb.isEmpty());
+    rb.pushBack(5);
+    TEST_ASSERT_EQUAL(5, rb.front());
+}
+
+void test_rolling_buffer_compressed_incompressible()
+{
+    // full range samples do not compress, so frames fall off the front when the pool is full
+    static RollingBufferCompressed<256, 256, 16> rb;
+    std::vector<int32_t> reference;
+    uint32_t seed = 7;
+    for (size_t ii = 0; ii < 1000; ++ii) {
+        seed = seed * 1664525U + 1013904223U;
+        reference.push_back(static_cast<int32_t>(seed));
+        rb.pushBack(reference.back());
+        TEST_ASSERT_TRUE(rb.bytesUsed() <= 256);
+    }
+    TEST_ASSERT_TRUE(rb.size() < 256);
+    TEST_ASSERT_TRUE(rb.size() >= 16);
+    const size_t offset = reference.size() - rb.size();
+    for (size_t ii = 0; ii < rb.size(); ++ii) {
+        TEST_ASSERT_EQUAL(reference[offset + ii], rb[ii]);
+    }
+
+    // extreme differences wrap correctly
+    static RollingBufferCompressed<64, 256, 32> rbe;
+    for (size_t ii = 0; ii < 64; ++ii) {
+        rbe.pushBack(ii % 2 == 0 ? INT32_MIN : INT32_MAX);
+    }
+    for (size_t ii = 0; ii < 64; ++ii) {
+        TEST_ASSERT_EQUAL(ii % 2 == 0 ? INT32_MIN : INT32_MAX, rbe[ii]);
+    }
+    // constant signal takes no payload
+    static RollingBufferCompressed<64, 128, 32> rbc;
+    for (size_t ii = 0; ii < 200; ++ii) {
+        rbc.pushBack(-42);
+    }
+    TEST_ASSERT_EQUAL(0, rbc.bytesUsed());
+    TEST_ASSERT_EQUAL(-42, rbc[3]);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_rolling_buffer_compressed);
+    RUN_TEST(test_rolling_buffer_compressed_incompressible);
+
+    UNITY_END();
+}
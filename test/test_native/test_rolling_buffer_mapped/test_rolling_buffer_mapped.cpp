@@ -0,0 +1,133 @@
+#include "RollingBufferMapped.h"
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <unity.h>
+
+static const char* fileName = "test_rolling_buffer_mapped.bin";
+
+void setUp() {
+    std::remove(fileName);
+}
+
+void tearDown() {
+    std::remove(fileName);
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+void test_rolling_buffer_mapped()
+{
+    using rolling_buffer_t = RollingBufferMapped<int, 4>;
+    {
+    rolling_buffer_t rb(fileName);
+    TEST_ASSERT_TRUE(rb.isMapped());
+    TEST_ASSERT_EQUAL(rolling_buffer_t::CREATED, rb.getAttachStatus());
+    TEST_ASSERT_TRUE(rb.isEmpty());
+    for (int ii = 1; ii <= 6; ++ii) {
+        rb.pushBack(ii);
+    }
+    TEST_ASSERT_EQUAL(4, rb.size());
+    TEST_ASSERT_EQUAL(3, rb.front());
+    TEST_ASSERT_EQUAL(6, rb.back());
+    }
+
+    // reattach: the history is still there
+    {
+    rolling_buffer_t rb(fileName);
+    TEST_ASSERT_EQUAL(rolling_buffer_t::ATTACHED, rb.getAttachStatus());
+    TEST_ASSERT_EQUAL(6, rb.count());
+    TEST_ASSERT_EQUAL(4, rb.size());
+    TEST_ASSERT_EQUAL(3, rb[0]);
+    TEST_ASSERT_EQUAL(4, rb[1]);
+    TEST_ASSERT_EQUAL(5, rb[2]);
+    TEST_ASSERT_EQUAL(6, rb[3]);
+    rb.pushBack(7);
+    TEST_ASSERT_EQUAL(4, rb.front());
+    TEST_ASSERT_EQUAL(7, rb.back());
+    TEST_ASSERT_TRUE(rb.sync());
+    }
+
+    // a buffer with a different capacity does not attach to the file
+    {
+    using rolling_buffer5_t = RollingBufferMapped<int, 5>;
+    rolling_buffer5_t rb(fileName);
+    TEST_ASSERT_EQUAL(rolling_buffer5_t::CREATED, rb.getAttachStatus());
+    TEST_ASSERT_TRUE(rb.isEmpty());
+    }
+}
+
+void test_rolling_buffer_mapped_clear()
+{
+    {
+    RollingBufferMapped<int, 4> rb(fileName);
+    rb.pushBack(1);
+    rb.pushBack(2);
+    rb.clear();
+    TEST_ASSERT_TRUE(rb.isEmpty());
+    rb.pushBack(3);
+    }
+    RollingBufferMapped<int, 4> rb(fileName);
+    TEST_ASSERT_EQUAL(1, rb.size());
+    TEST_ASSERT_EQUAL(3, rb.front());
+}
+
+void test_rolling_buffer_mapped_torn_write()
+{
+    using rolling_buffer_t = RollingBufferMapped<int, 3>;
+    {
+    rolling_buffer_t rb(fileName);
+    rb.pushBack(1);
+    rb.pushBack(2);
+    }
+    // simulate a crash part way through writing a third item: the sequence number is odd and the item is partly written
+    {
+    std::fstream file(fileName, std::ios::in | std::ios::out | std::ios::binary);
+    const uint64_t sequence = 2*2 + 1;
+    file.seekp(offsetof(rolling_buffer_t::header_t, sequence));
+    file.write(reinterpret_cast<const char*>(&sequence), sizeof(sequence)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    const char partial = 0x7F;
+    file.seekp(static_cast<std::streamoff>(rolling_buffer_t::ITEMS_OFFSET + 2*sizeof(int)));
+    file.write(&partial, 1);
+    }
+    {
+    rolling_buffer_t rb(fileName);
+    TEST_ASSERT_EQUAL(rolling_buffer_t::ATTACHED_TORN_WRITE_DISCARDED, rb.getAttachStatus());
+    TEST_ASSERT_EQUAL(2, rb.size());
+    TEST_ASSERT_EQUAL(1, rb.front());
+    TEST_ASSERT_EQUAL(2, rb.back());
+    rb.pushBack(3);
+    TEST_ASSERT_EQUAL(3, rb.back());
+    }
+    // the torn write has been repaired
+    rolling_buffer_t rb(fileName);
+    TEST_ASSERT_EQUAL(rolling_buffer_t::ATTACHED, rb.getAttachStatus());
+    TEST_ASSERT_EQUAL(3, rb.size());
+}
+
+void test_rolling_buffer_mapped_not_mapped()
+{
+    // the directory does not exist, so the file cannot be opened
+    using rolling_buffer_t = RollingBufferMapped<int, 4>;
+    rolling_buffer_t rb("no_such_directory/test_rolling_buffer_mapped.bin");
+    TEST_ASSERT_FALSE(rb.isMapped());
+    TEST_ASSERT_EQUAL(rolling_buffer_t::NOT_MAPPED, rb.getAttachStatus());
+    TEST_ASSERT_FALSE(rb.pushBack(1));
+    TEST_ASSERT_TRUE(rb.isEmpty());
+    TEST_ASSERT_EQUAL(0, rb.count());
+    rb.clear();
+    TEST_ASSERT_TRUE(rb.isEmpty());
+    TEST_ASSERT_FALSE(rb.sync());
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_rolling_buffer_mapped);
+    RUN_TEST(test_rolling_buffer_mapped_clear);
+    RUN_TEST(test_rolling_buffer_mapped_torn_write);
+    RUN_TEST(test_rolling_buffer_mapped_not_mapped);
+
+    UNITY_END();
+}
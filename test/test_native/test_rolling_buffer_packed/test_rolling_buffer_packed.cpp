@@ -0,0 +1,131 @@
+#include "RollingBufferPacked.h"
+#include <cmath>
+#include <limits>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+void test_float16_storage()
+{
+    TEST_ASSERT_EQUAL_HEX16(0x0000, Float16Storage::pack(0.0F));
+    TEST_ASSERT_EQUAL_HEX16(0x8000, Float16Storage::pack(-0.0F));
+    TEST_ASSERT_EQUAL_HEX16(0x3C00, Float16Storage::pack(1.0F));
+    TEST_ASSERT_EQUAL_HEX16(0xC000, Float16Storage::pack(-2.0F));
+    TEST_ASSERT_EQUAL_HEX16(0x7BFF, Float16Storage::pack(65504.0F));
+    TEST_ASSERT_EQUAL_HEX16(0x7C00, Float16Storage::pack(1.0e6F));
+    TEST_ASSERT_EQUAL_HEX16(0x0001, Float16Storage::pack(5.9604645e-8F)); // smallest subnormal
+    TEST_ASSERT_EQUAL_HEX16(0x3C00, Float16Storage::pack(1.0F + 1.0F/4096.0F)); // rounds to even
+    TEST_ASSERT_EQUAL_HEX16(0x3C02, Float16Storage::pack(1.0F + 3.0F/2048.0F)); // tie rounds to even
+
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, Float16Storage::unpack(0x3C00));
+    TEST_ASSERT_EQUAL_FLOAT(-2.0F, Float16Storage::unpack(0xC000));
+    TEST_ASSERT_EQUAL_FLOAT(65504.0F, Float16Storage::unpack(0x7BFF));
+    TEST_ASSERT_EQUAL_FLOAT(5.9604645e-8F, Float16Storage::unpack(0x0001));
+    TEST_ASSERT_TRUE(std::isinf(Float16Storage::unpack(0xFC00)));
+    TEST_ASSERT_TRUE(std::isnan(Float16Storage::unpack(Float16Storage::pack(std::numeric_limits<float>::quiet_NaN()))));
+
+    // every finite half round trips exactly
+    for (uint32_t half = 0; half < 0x10000; ++half) {
+        if ((half & 0x7C00U) != 0x7C00U) {
+            const auto h = static_cast<uint16_t>(half);
+            TEST_ASSERT_EQUAL_HEX16(h, Float16Storage::pack(Float16Storage::unpack(h)));
+        }
+    }
+    // relative error is bounded
+    for (float value = 0.001F; value < 60000.0F; value *= 1.01F) {
+        TEST_ASSERT_FLOAT_WITHIN(value / 2048.0F, value, Float16Storage::unpack(Float16Storage::pack(value)));
+    }
+}
+
+void test_bfloat16_storage()
+{
+    TEST_ASSERT_EQUAL_HEX16(0x3F80, BFloat16Storage::pack(1.0F));
+    TEST_ASSERT_EQUAL_HEX16(0xC000, BFloat16Storage::pack(-2.0F));
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, BFloat16Storage::unpack(0x3F80));
+    TEST_ASSERT_TRUE(std::isnan(BFloat16Storage::unpack(BFloat16Storage::pack(std::numeric_limits<float>::quiet_NaN()))));
+    for (float value = 1.0e-30F; value < 1.0e30F; value *= 1.1F) {
+        TEST_ASSERT_FLOAT_WITHIN(value / 256.0F, value, BFloat16Storage::unpack(BFloat16Storage::pack(value)));
+    }
+}
+
+void test_int16_scaled_storage()
+{
+    using storage_t = Int16ScaledStorage<2000>;
+    TEST_ASSERT_EQUAL(0, storage_t::pack(0.0F));
+    TEST_ASSERT_EQUAL(32767, storage_t::pack(2000.0F));
+    TEST_ASSERT_EQUAL(-32767, storage_t::pack(-2000.0F));
+    TEST_ASSERT_EQUAL(32767, storage_t::pack(5000.0F));
+    TEST_ASSERT_EQUAL(-32767, storage_t::pack(-5000.0F));
+    TEST_ASSERT_EQUAL(0, storage_t::pack(std::numeric_limits<float>::quiet_NaN()));
+    for (float value = -2000.0F; value <= 2000.0F; value += 0.37F) {
+        TEST_ASSERT_FLOAT_WITHIN(2000.0F / 65534.0F * 1.01F, value, storage_t::unpack(storage_t::pack(value)));
+    }
+}
+
+void test_rolling_buffer_packed()
+{
+    static RollingBufferPacked<Float16Storage, 4> rb;
+    static_assert(sizeof(rb) < 3*sizeof(size_t) + 5*sizeof(float));
+    TEST_ASSERT_TRUE(rb.isEmpty());
+    for (int ii = 1; ii <= 6; ++ii) {
+        rb.pushBack(static_cast<float>(ii) + 0.5F);
+    }
+    TEST_ASSERT_EQUAL(4, rb.size());
+    TEST_ASSERT_EQUAL_FLOAT(3.5F, rb.front());
+    TEST_ASSERT_EQUAL_FLOAT(6.5F, rb.back());
+    TEST_ASSERT_EQUAL_FLOAT(4.5F, rb[1]);
+    float expected = 3.5F;
+    for (float value : rb) {
+        TEST_ASSERT_EQUAL_FLOAT(expected, value);
+        expected += 1.0F;
+    }
+    std::array<float, 4> dest {};
+    rb.copy(dest);
+    TEST_ASSERT_EQUAL_FLOAT(3.5F, dest[0]);
+    TEST_ASSERT_EQUAL_FLOAT(4.5F, dest[1]);
+    TEST_ASSERT_EQUAL_FLOAT(5.5F, dest[2]);
+    TEST_ASSERT_EQUAL_FLOAT(6.5F, dest[3]);
+}
+
+void test_rolling_buffer_packed_with_sum()
+{
+    static RollingBufferPackedWithSum<Int16ScaledStorage<2000>, 100, double> rb;
+    uint32_t seed = 1;
+    for (int ii = 0; ii < 1'000'000; ++ii) {
+        seed = seed * 1664525U + 1013904223U;
+        rb.pushBack(static_cast<float>(seed >> 8) / 16777216.0F * 4000.0F - 2000.0F);
+    }
+    double exact = 0.0;
+    for (float value : rb) {
+        exact += static_cast<double>(value);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-6F, static_cast<float>(exact), static_cast<float>(rb.sum()));
+    TEST_ASSERT_FLOAT_WITHIN(1.0e-6F, static_cast<float>(exact), static_cast<float>(rb.recalculateSum()));
+
+    static RollingBufferPackedWithSum<BFloat16Storage, 3> rbf;
+    rbf.pushBack(1.0F);
+    rbf.pushBack(2.0F);
+    rbf.pushBack(3.0F);
+    rbf.pushBack(4.0F);
+    TEST_ASSERT_EQUAL_FLOAT(9.0F, rbf.sum());
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, rbf.front());
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_float16_storage);
+    RUN_TEST(test_bfloat16_storage);
+    RUN_TEST(test_int16_scaled_storage);
+    RUN_TEST(test_rolling_buffer_packed);
+    RUN_TEST(test_rolling_buffer_packed_with_sum);
+
+    UNITY_END();
+}
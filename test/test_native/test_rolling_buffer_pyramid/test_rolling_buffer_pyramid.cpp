@@ -0,0 +1,105 @@
+#include "RollingBufferPyramid.h"
+#include <vector>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+using pyramid_t = RollingBufferPyramid<int, 20, 4, 3>;
+
+static pyramid_t::aggregate_t bruteForce(const std::vector<int>& samples, size_t begin, size_t end)
+{
+    pyramid_t::aggregate_t ret { samples[begin], samples[begin], 0, 0 };
+    for (size_t ii = begin; ii < end; ++ii) {
+        ret.min = samples[ii] < ret.min ? samples[ii] : ret.min;
+        ret.max = samples[ii] > ret.max ? samples[ii] : ret.max;
+        ret.sum += samples[ii];
+        ++ret.count;
+    }
+    return ret;
+}
+
+static void assertAggregate(const pyramid_t::aggregate_t& expected, const pyramid_t::aggregate_t& actual)
+{
+    TEST_ASSERT_EQUAL(expected.count, actual.count);
+    TEST_ASSERT_EQUAL(expected.min, actual.min);
+    TEST_ASSERT_EQUAL(expected.max, actual.max);
+    TEST_ASSERT_EQUAL(expected.sum, actual.sum);
+}
+
+void test_rolling_buffer_pyramid()
+{
+    static_assert(pyramid_t::resolution(2) == 16);
+    static pyramid_t pyramid;
+    TEST_ASSERT_TRUE(pyramid.isEmpty());
+    TEST_ASSERT_EQUAL(0, pyramid.aggregateRecent(10).count);
+
+    std::vector<int> samples;
+    for (size_t ii = 0; ii < 1000; ++ii) {
+        const int value = static_cast<int>((ii*37) % 101) - 50;
+        samples.push_back(value);
+        pyramid.pushBack(value);
+        TEST_ASSERT_EQUAL(value, pyramid.back());
+
+        // recent spans are held at full resolution, so are exact
+        for (size_t count = 1; count <= pyramid.size(); count += 3) {
+            assertAggregate(bruteForce(samples, samples.size() - count, samples.size()), pyramid.aggregateRecent(count));
+        }
+    }
+    TEST_ASSERT_EQUAL(1000, pyramid.count());
+    TEST_ASSERT_EQUAL(20, pyramid.size());
+    TEST_ASSERT_EQUAL(samples[980], pyramid[0]);
+
+    // spans whose old end is on the resolution boundary of the level that holds it are exact
+    // level 1 holds samples 920 to 1000, level 2 holds samples 672 to 992
+    assertAggregate(bruteForce(samples, 960, 1000), pyramid.aggregate(960, 1000));
+    assertAggregate(bruteForce(samples, 924, 985), pyramid.aggregate(924, 985));
+    assertAggregate(bruteForce(samples, 672, 1000), pyramid.aggregate(672, 1000));
+    assertAggregate(bruteForce(samples, 688, 704), pyramid.aggregate(688, 704));
+
+    // otherwise the ends are rounded outwards to the resolution of the level that holds them
+    assertAggregate(bruteForce(samples, 704, 932), pyramid.aggregate(704, 931));
+    assertAggregate(bruteForce(samples, 920, 1000), pyramid.aggregate(922, 1000));
+    assertAggregate(bruteForce(samples, 688, 1000), pyramid.aggregate(700, 1000));
+    assertAggregate(bruteForce(samples, 688, 997), pyramid.aggregate(700, 997));
+    // and truncated to the history held
+    assertAggregate(bruteForce(samples, 672, 1000), pyramid.aggregate(0, 1000));
+    assertAggregate(bruteForce(samples, 672, 1000), pyramid.aggregateRecent(1000));
+
+    const pyramid_t::aggregate_t aggregate = pyramid.aggregateRecent(20);
+    TEST_ASSERT_EQUAL(aggregate.sum / 20, aggregate.mean());
+
+    pyramid.reset();
+    TEST_ASSERT_TRUE(pyramid.isEmpty());
+    pyramid.pushBack(7);
+    assertAggregate(pyramid_t::aggregate_t { 7, 7, 7, 1 }, pyramid.aggregateRecent(5));
+}
+
+void test_rolling_buffer_pyramid_float()
+{
+    static RollingBufferPyramid<float, 100, 10, 4, double> pyramid;
+    for (size_t ii = 0; ii < 100000; ++ii) {
+        pyramid.pushBack(static_cast<float>(ii % 1000));
+    }
+    // the last 100000 samples are held at a resolution of 1000 samples
+    const auto aggregate = pyramid.aggregateRecent(100000);
+    TEST_ASSERT_EQUAL(100000, aggregate.count);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, aggregate.min);
+    TEST_ASSERT_EQUAL_FLOAT(999.0F, aggregate.max);
+    TEST_ASSERT_EQUAL_DOUBLE(499.5, aggregate.mean());
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_rolling_buffer_pyramid);
+    RUN_TEST(test_rolling_buffer_pyramid_float);
+
+    UNITY_END();
+}
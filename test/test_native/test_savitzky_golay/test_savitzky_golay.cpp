@@ -0,0 +1,96 @@
+#include "SavitzkyGolay.h"
+#include <cmath>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+void test_savitzky_golay_coefficients()
+{
+    // the classic 5-point quadratic coefficients, which are symmetric, so are the same newest first or oldest first
+    using sg5_2 = SavitzkyGolayFilter<5, 2>;
+    TEST_ASSERT_FLOAT_WITHIN(1e-6F, -3.0F/35.0F, sg5_2::getCoefficient(sg5_2::VALUE, 0));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6F, 12.0F/35.0F, sg5_2::getCoefficient(sg5_2::VALUE, 1));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6F, 17.0F/35.0F, sg5_2::getCoefficient(sg5_2::VALUE, 2));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6F, 12.0F/35.0F, sg5_2::getCoefficient(sg5_2::VALUE, 3));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6F, -3.0F/35.0F, sg5_2::getCoefficient(sg5_2::VALUE, 4));
+    // derivative coefficients are antisymmetric, the newest sample (t = 0) has positive weight
+    TEST_ASSERT_FLOAT_WITHIN(1e-6F, 0.2F, sg5_2::getCoefficient(sg5_2::DERIVATIVE, 0));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6F, 0.1F, sg5_2::getCoefficient(sg5_2::DERIVATIVE, 1));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6F, 0.0F, sg5_2::getCoefficient(sg5_2::DERIVATIVE, 2));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6F, -0.2F, sg5_2::getCoefficient(sg5_2::DERIVATIVE, 4));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6F, 2.0F/7.0F, sg5_2::getCoefficient(sg5_2::SECOND_DERIVATIVE, 0));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6F, -1.0F/7.0F, sg5_2::getCoefficient(sg5_2::SECOND_DERIVATIVE, 1));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6F, -2.0F/7.0F, sg5_2::getCoefficient(sg5_2::SECOND_DERIVATIVE, 2));
+
+    // the coefficients are calculated at compile time
+    static_assert(SavitzkyGolayFilter<7, 3>::getCoefficient(0, 3) > 0.3F);
+    // the value coefficients sum to 1, the derivative coefficients to 0
+    using sg11_4 = SavitzkyGolayFilter<11, 4>;
+    float valueSum = 0.0F;
+    float derivativeSum = 0.0F;
+    for (size_t ii = 0; ii < 11; ++ii) {
+        valueSum += sg11_4::getCoefficient(sg11_4::VALUE, ii);
+        derivativeSum += sg11_4::getCoefficient(sg11_4::DERIVATIVE, ii);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-5F, 1.0F, valueSum);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5F, 0.0F, derivativeSum);
+}
+
+void test_savitzky_golay_polynomial()
+{
+    // a quadratic is fitted exactly, so the value and derivatives are exact, delayed by half the window
+    constexpr float dT = 0.01F;
+    static SavitzkyGolayFilter<9, 2> filter(dT);
+    auto position = [](float t) { return 1.0F + 2.0F*t - 3.0F*t*t; };
+    for (int ii = 0; ii < 20; ++ii) {
+        filter.filter(position(static_cast<float>(ii)*dT));
+    }
+    const float t = static_cast<float>(19 - 4)*dT;
+    TEST_ASSERT_FLOAT_WITHIN(1e-4F, position(t), filter.getValue());
+    TEST_ASSERT_FLOAT_WITHIN(1e-3F, 2.0F - 6.0F*t, filter.getDerivative());
+    TEST_ASSERT_FLOAT_WITHIN(0.1F, -6.0F, filter.getSecondDerivative());
+
+    // evaluated at the newest sample, there is no delay
+    static SavitzkyGolayFilter<9, 2, 8> causal(dT);
+    causal.reset(position(0.0F));
+    for (int ii = 0; ii < 20; ++ii) {
+        causal.filter(position(static_cast<float>(ii)*dT));
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-4F, position(19*dT), causal.getValue());
+    TEST_ASSERT_FLOAT_WITHIN(1e-3F, 2.0F - 6.0F*19*dT, causal.getDerivative());
+    TEST_ASSERT_FLOAT_WITHIN(0.1F, -6.0F, causal.getSecondDerivative());
+}
+
+void test_savitzky_golay_noise()
+{
+    // alternating noise on a constant is strongly attenuated
+    static SavitzkyGolayFilter<11, 2> filter;
+    filter.reset(5.0F);
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, filter.getValue());
+    float maxError = 0.0F;
+    for (int ii = 0; ii < 100; ++ii) {
+        const float output = filter.filter((ii & 1) ? 6.0F : 4.0F);
+        maxError = std::fmax(maxError, std::fabs(output - 5.0F));
+    }
+    TEST_ASSERT_TRUE(maxError < 0.2F);
+    filter.reset();
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, filter.getValue());
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, filter.filter(0.0F));
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_savitzky_golay_coefficients);
+    RUN_TEST(test_savitzky_golay_polynomial);
+    RUN_TEST(test_savitzky_golay_noise);
+
+    UNITY_END();
+}
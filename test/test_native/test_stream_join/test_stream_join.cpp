@@ -0,0 +1,137 @@
+#include "StreamJoin.h"
+#include <array>
+#include <cstdint>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+void test_stream_join()
+{
+    static StreamJoin<2, 8> join;
+    TEST_ASSERT_EQUAL(2, join.streamCount());
+    TEST_ASSERT_EQUAL(8, join.capacity());
+
+    float value = -1.0F;
+    TEST_ASSERT_FALSE(join.interpolate(0, 100, value)); // empty stream
+    TEST_ASSERT_EQUAL_FLOAT(-1.0F, value);
+
+    join.pushBack(0, 100, 1.0F);
+    join.pushBack(0, 200, 3.0F);
+    join.pushBack(0, 400, 7.0F);
+    join.pushBack(1, 150, 10.0F);
+    join.pushBack(1, 350, 20.0F);
+    TEST_ASSERT_EQUAL(3, join.size(0));
+    TEST_ASSERT_EQUAL(400, join.back(0).timestamp);
+
+    TEST_ASSERT_FALSE(join.interpolate(0, 99, value)); // before the oldest sample
+    TEST_ASSERT_TRUE(join.interpolate(0, 100, value));
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, value);
+    TEST_ASSERT_TRUE(join.interpolate(0, 150, value));
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, value);
+    TEST_ASSERT_TRUE(join.interpolate(0, 300, value));
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, value);
+    TEST_ASSERT_TRUE(join.interpolate(0, 400, value));
+    TEST_ASSERT_EQUAL_FLOAT(7.0F, value);
+    TEST_ASSERT_FALSE(join.interpolate(0, 401, value)); // after the newest sample
+    // an earlier timestamp moves the cursor back
+    TEST_ASSERT_TRUE(join.interpolate(0, 125, value));
+    TEST_ASSERT_EQUAL_FLOAT(1.5F, value);
+
+    std::array<float, 2> values {};
+    TEST_ASSERT_TRUE(join.interpolate(250, values));
+    TEST_ASSERT_EQUAL_FLOAT(4.0F, values[0]);
+    TEST_ASSERT_EQUAL_FLOAT(15.0F, values[1]);
+    // stream 1 does not reach 375, but stream 0 is still interpolated
+    TEST_ASSERT_FALSE(join.interpolate(375, values));
+    TEST_ASSERT_EQUAL_FLOAT(6.5F, values[0]);
+    TEST_ASSERT_EQUAL_FLOAT(15.0F, values[1]);
+
+    join.clear();
+    TEST_ASSERT_EQUAL(0, join.size(0));
+    TEST_ASSERT_FALSE(join.interpolate(0, 250, value));
+}
+
+void test_stream_join_overwrite()
+{
+    static StreamJoin<1, 4> join;
+    join.pushBack(0, 10, 1.0F);
+    join.pushBack(0, 20, 2.0F);
+    float value = 0.0F;
+    TEST_ASSERT_TRUE(join.interpolate(0, 15, value));
+    TEST_ASSERT_EQUAL_FLOAT(1.5F, value);
+    // overwrite the sample the cursor is on
+    for (uint32_t ii = 3; ii <= 8; ++ii) {
+        join.pushBack(0, ii*10, static_cast<float>(ii));
+    }
+    TEST_ASSERT_EQUAL(4, join.size(0));
+    TEST_ASSERT_FALSE(join.interpolate(0, 45, value));
+    TEST_ASSERT_TRUE(join.interpolate(0, 55, value));
+    TEST_ASSERT_EQUAL_FLOAT(5.5F, value);
+    TEST_ASSERT_TRUE(join.interpolate(0, 80, value));
+    TEST_ASSERT_EQUAL_FLOAT(8.0F, value);
+}
+
+namespace {
+// simple deterministic pseudo-random jitter in [-range, range]
+int32_t jitter(uint32_t& state, int32_t range)
+{
+    state = state*1664525U + 1013904223U;
+    return static_cast<int32_t>((state >> 16U) % static_cast<uint32_t>(2*range + 1)) - range;
+}
+} // namespace
+
+void test_stream_join_jittered()
+{
+    // gyro at about 1kHz, baro at about 50Hz, with jittered timestamps, joined onto a 500Hz output clock.
+    // The timer starts just before it wraps around.
+    // The signals are linear in time, so linear interpolation is exact, whatever the jitter.
+    enum { GYRO = 0, BARO = 1 };
+    static StreamJoin<2, 64> join;
+    const uint32_t start = 0xFFFF0000U;
+    auto gyroSignal = [](uint32_t t) { return 0.001F * static_cast<float>(static_cast<int32_t>(t - start)); };
+    auto baroSignal = [](uint32_t t) { return 100.0F - 0.0005F * static_cast<float>(static_cast<int32_t>(t - start)); };
+
+    uint32_t state = 12345;
+    uint32_t gyroTime = start;
+    uint32_t baroTime = start;
+    uint32_t outputTime = start + 1000;
+    size_t outputCount = 0;
+    std::array<float, 2> values {};
+    for (int ii = 0; ii < 2000000; ++ii) {
+        const uint32_t now = start + static_cast<uint32_t>(ii);
+        if (now == gyroTime) {
+            join.pushBack(GYRO, gyroTime, gyroSignal(gyroTime));
+            gyroTime += static_cast<uint32_t>(1000 + jitter(state, 100));
+        }
+        if (now == baroTime) {
+            join.pushBack(BARO, baroTime, baroSignal(baroTime));
+            baroTime += static_cast<uint32_t>(20000 + jitter(state, 2000));
+        }
+        // output once every stream has a sample after the output time
+        if (static_cast<int32_t>(join.back(BARO).timestamp - outputTime) >= 0 && static_cast<int32_t>(join.back(GYRO).timestamp - outputTime) >= 0) {
+            TEST_ASSERT_TRUE(join.interpolate(outputTime, values));
+            TEST_ASSERT_FLOAT_WITHIN(0.01F, gyroSignal(outputTime), values[GYRO]);
+            TEST_ASSERT_FLOAT_WITHIN(0.01F, baroSignal(outputTime), values[BARO]);
+            outputTime += 2000;
+            ++outputCount;
+        }
+    }
+    TEST_ASSERT_TRUE(outputCount > 980);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_stream_join);
+    RUN_TEST(test_stream_join_overwrite);
+    RUN_TEST(test_stream_join_jittered);
+
+    UNITY_END();
+}
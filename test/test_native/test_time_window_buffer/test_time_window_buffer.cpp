@@ -0,0 +1,98 @@
+#include "TimeWindowBuffer.h"
+#include <algorithm>
+#include <vector>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+void test_time_window_buffer()
+{
+    static TimeWindowBuffer<float, 8> buffer(500);
+    TEST_ASSERT_TRUE(buffer.isEmpty());
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, buffer.mean());
+    buffer.pushBack(1000, 3.0F);
+    buffer.pushBack(1100, 1.0F);
+    buffer.pushBack(1350, 5.0F);
+    TEST_ASSERT_EQUAL(3, buffer.size());
+    TEST_ASSERT_EQUAL_FLOAT(9.0F, buffer.sum());
+    TEST_ASSERT_EQUAL_FLOAT(3.0F, buffer.mean());
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, buffer.min());
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, buffer.max());
+    TEST_ASSERT_EQUAL(1000, buffer.front().timestamp);
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, buffer.back().value);
+
+    // at 1500 the value at 1000 is 500 old, so has expired
+    buffer.expire(1500);
+    TEST_ASSERT_EQUAL(2, buffer.size());
+    TEST_ASSERT_EQUAL_FLOAT(6.0F, buffer.sum());
+    buffer.pushBack(1650, 2.0F);
+    TEST_ASSERT_EQUAL(2, buffer.size());
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, buffer.min());
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, buffer.max());
+    TEST_ASSERT_EQUAL_FLOAT(3.5F, buffer.mean());
+    buffer.expire(2200);
+    TEST_ASSERT_TRUE(buffer.isEmpty());
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, buffer.sum());
+
+    // once full, the oldest values fall off the front
+    for (uint32_t ii = 0; ii < 10; ++ii) {
+        buffer.pushBack(3000 + ii, static_cast<float>(ii));
+    }
+    TEST_ASSERT_EQUAL(8, buffer.size());
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, buffer.min());
+    TEST_ASSERT_EQUAL_FLOAT(9.0F, buffer.max());
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, buffer[0].value);
+
+    buffer.clear();
+    TEST_ASSERT_TRUE(buffer.isEmpty());
+}
+
+void test_time_window_buffer_random()
+{
+    // irregular timestamps on a 16-bit timer that wraps around, checked against brute force
+    static TimeWindowBuffer<int32_t, 64, uint16_t, int64_t> buffer(300);
+    std::vector<std::pair<uint32_t, int32_t>> reference;
+    uint32_t seed = 1;
+    uint32_t time = 60000;
+    for (size_t ii = 0; ii < 20000; ++ii) {
+        seed = seed * 1664525U + 1013904223U;
+        time += (seed >> 24U) % 20; // 0 to 19 ticks between samples, sometimes the same timestamp
+        const auto value = static_cast<int32_t>((seed >> 8U) % 2001) - 1000;
+        buffer.pushBack(static_cast<uint16_t>(time), value);
+        reference.emplace_back(time, value);
+
+        int64_t sum = 0;
+        int32_t minValue = INT32_MAX;
+        int32_t maxValue = INT32_MIN;
+        size_t count = 0;
+        for (size_t jj = reference.size(); jj > 0 && count < 64; --jj) {
+            if (time - reference[jj - 1].first >= 300) {
+                break;
+            }
+            sum += reference[jj - 1].second;
+            minValue = std::min(minValue, reference[jj - 1].second);
+            maxValue = std::max(maxValue, reference[jj - 1].second);
+            ++count;
+        }
+        TEST_ASSERT_EQUAL(count, buffer.size());
+        TEST_ASSERT_EQUAL(sum, buffer.sum());
+        TEST_ASSERT_EQUAL(minValue, buffer.min());
+        TEST_ASSERT_EQUAL(maxValue, buffer.max());
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_time_window_buffer);
+    RUN_TEST(test_time_window_buffer_random);
+
+    UNITY_END();
+}